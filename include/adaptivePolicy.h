@@ -0,0 +1,222 @@
+#ifndef ADAPTIVEPOLICY
+#define ADAPTIVEPOLICY
+
+#include "memorySegment.h"
+#include "dynamicMemoryManagement.h"
+
+/**
+ * Adaptive dynamic memory allocation. The requests are served by one of the First, Best or Next Fit methods, and the
+ * method is re-evaluated at the end of each epoch (a fixed number of requests), from the scan lengths, the failure
+ * rate and the fragmentation sampled from the memory itself. A new method is only adopted once it was chosen for
+ * SwitchEpochs epochs in a row, so that the method does not flap on a workload near one of the thresholds. The methods
+ * share the same memory list, so switching between them never moves or changes the allocated blocks.
+ */
+
+typedef enum assignPolicy {
+    FIRST_FIT,
+    BEST_FIT,
+    NEXT_FIT
+} assignPolicy;
+
+#define DefaultEpochLength 256
+#define ScanLengthThreshold 32.0
+#define FailureRateThreshold 0.01
+#define FragmentationThreshold 0.5
+#define SwitchEpochs 2
+
+/**
+ * The state of the adaptive method: the active method, and the samples of the running epoch.
+ */
+typedef struct adaptivePolicy {
+    assignPolicy policy;
+    uint32_t epochLength;
+    uint32_t epoch;
+    uint32_t requests;
+    uint32_t failures;
+    uint32_t nextFitMisses;
+    uint64_t visitedAtEpochStart;
+    assignPolicy candidate;
+    uint32_t candidateEpochs;
+    uint32_t switches;
+    FILE *log;
+} adaptivePolicy;
+
+static _Thread_local adaptivePolicy adaptiveState = {FIRST_FIT, DefaultEpochLength, 0, 0, 0, 0, 0, FIRST_FIT, 0, 0,
+                                                     NULL};
+
+const char *policyName(assignPolicy policy) {
+    switch (policy) {
+        case FIRST_FIT:
+            return "AF";
+        case BEST_FIT:
+            return "AB";
+        default:
+            return "AN";
+    }
+}
+
+/**
+ * Resets the adaptive method, which starts with First Fit.
+ *
+ * @param epochLength the number of requests between two re-evaluations of the method.
+ * @param log the stream where the decisions are written, or NULL to disable logging.
+ */
+void initializeAdaptivePolicy(uint32_t epochLength, FILE *log) {
+    adaptiveState.policy = FIRST_FIT;
+    adaptiveState.epochLength = epochLength > 0 ? epochLength : DefaultEpochLength;
+    adaptiveState.epoch = 0;
+    adaptiveState.requests = 0;
+    adaptiveState.failures = 0;
+    adaptiveState.nextFitMisses = 0;
+    adaptiveState.visitedAtEpochStart = segmentsVisited;
+    adaptiveState.candidate = FIRST_FIT;
+    adaptiveState.candidateEpochs = 0;
+    adaptiveState.switches = 0;
+    adaptiveState.log = log;
+}
+
+/**
+ * Chooses the method for the next epoch. High fragmentation or a high failure rate calls for Best Fit, which keeps the
+ * large free blocks intact. The requests that Next Fit could only serve by searching again from the start count as
+ * failures here, since they show that the memory after the last block is running out; each request counts once, as a
+ * failure or as such a miss. Long scans on an unfragmented memory call for Next Fit, which resumes where the last
+ * search ended. Otherwise First Fit is used.
+ *
+ * @param memList the memory as a linked list, with each node representing a memory block.
+ */
+void endEpoch(memorySegment *memList) {
+    uint32_t totalFree = 0;
+    uint16_t largestFree = 0;
+    uint32_t segments = 0;
+    memorySegment *currentSegment = memList;
+
+    while (currentSegment != NULL) {
+        segments++;
+        if (!currentSegment->occupied) {
+            totalFree += currentSegment->length;
+            if (currentSegment->length > largestFree) {
+                largestFree = currentSegment->length;
+            }
+        }
+        currentSegment = currentSegment->next;
+    }
+
+    double scanLength = (double)(segmentsVisited - adaptiveState.visitedAtEpochStart) / adaptiveState.requests;
+    double failureRate = (double)(adaptiveState.failures + adaptiveState.nextFitMisses) / adaptiveState.requests;
+    double fragmentation = totalFree > 0 ? 1.0 - (double)largestFree / totalFree : 0.0;
+
+    assignPolicy policy;
+    if (fragmentation > FragmentationThreshold || failureRate > FailureRateThreshold) {
+        policy = BEST_FIT;
+    } else if (scanLength > ScanLengthThreshold) {
+        policy = NEXT_FIT;
+    } else {
+        policy = FIRST_FIT;
+    }
+
+    if (policy == adaptiveState.policy) {
+        adaptiveState.candidateEpochs = 0;
+    } else if (policy == adaptiveState.candidate) {
+        adaptiveState.candidateEpochs++;
+    } else {
+        adaptiveState.candidate = policy;
+        adaptiveState.candidateEpochs = 1;
+    }
+
+    if (policy != adaptiveState.policy && adaptiveState.candidateEpochs >= SwitchEpochs) {
+        if (adaptiveState.log != NULL) {
+            fprintf(adaptiveState.log, "epoch %u: scan %.1f, failures %.2f%%, fragmentation %.2f, %u blocks: "
+                    "%s -> %s\n", adaptiveState.epoch, scanLength, 100.0 * failureRate, fragmentation, segments,
+                    policyName(adaptiveState.policy), policyName(policy));
+        }
+        if (policy == NEXT_FIT) {
+            lastAllocatedBlock = NULL;
+        }
+        adaptiveState.policy = policy;
+        adaptiveState.candidateEpochs = 0;
+        adaptiveState.switches++;
+    }
+
+    adaptiveState.epoch++;
+    adaptiveState.requests = 0;
+    adaptiveState.failures = 0;
+    adaptiveState.nextFitMisses = 0;
+    adaptiveState.visitedAtEpochStart = segmentsVisited;
+}
+
+/**
+ * Counts a request in the samples of the running epoch, and ends the epoch once it is complete.
+ */
+memorySegment *countAdaptiveRequest(memorySegment *memList, memorySegment *allocatedBlock) {
+    adaptiveState.requests++;
+    if (allocatedBlock == NULL) {
+        adaptiveState.failures++;
+    }
+    if (adaptiveState.requests == adaptiveState.epochLength) {
+        endEpoch(memList);
+    }
+    return allocatedBlock;
+}
+
+/**
+ * Assigns the requested memory with the method of the current epoch. When Next Fit reaches the end of the memory
+ * without finding a block, the search is repeated from the start with First Fit.
+ *
+ * @param memList the memory as a linked list, with each node representing a memory block.
+ * @param requestedMem the memory requested by a process.
+ * @return memorySegment* the memory block that was allocated by the memory management service.
+ */
+memorySegment *assignAdaptiveDyn(memorySegment *memList, uint16_t requestedMem) {
+    memorySegment *allocatedBlock;
+
+    switch (adaptiveState.policy) {
+        case FIRST_FIT:
+            allocatedBlock = assignFirstDyn(memList, requestedMem);
+            break;
+        case BEST_FIT:
+            allocatedBlock = assignBestDyn(memList, requestedMem);
+            break;
+        default:
+            allocatedBlock = assignNextDyn(memList, requestedMem);
+            if (allocatedBlock == NULL) {
+                allocatedBlock = assignFirstDyn(memList, requestedMem);
+                /* a request that First Fit cannot serve either is counted as a failure only */
+                adaptiveState.nextFitMisses += allocatedBlock != NULL;
+            }
+            break;
+    }
+
+    return countAdaptiveRequest(memList, allocatedBlock);
+}
+
+/**
+ * Assigns the requested memory at the given alignment, with the aligned variant of the method of the current epoch.
+ *
+ * @param memList the memory as a linked list, with each node representing a memory block.
+ * @param requestedMem the memory requested by a process.
+ * @param alignment the alignment of the start address of the block, a power of two.
+ * @return memorySegment* the memory block that was allocated by the memory management service.
+ */
+memorySegment *assignAdaptiveAlignedDyn(memorySegment *memList, uint16_t requestedMem, uint16_t alignment) {
+    memorySegment *allocatedBlock;
+
+    switch (adaptiveState.policy) {
+        case FIRST_FIT:
+            allocatedBlock = assignFirstAlignedDyn(memList, requestedMem, alignment);
+            break;
+        case BEST_FIT:
+            allocatedBlock = assignBestAlignedDyn(memList, requestedMem, alignment);
+            break;
+        default:
+            allocatedBlock = assignNextAlignedDyn(memList, requestedMem, alignment);
+            if (allocatedBlock == NULL) {
+                allocatedBlock = assignFirstAlignedDyn(memList, requestedMem, alignment);
+                adaptiveState.nextFitMisses += allocatedBlock != NULL;
+            }
+            break;
+    }
+
+    return countAdaptiveRequest(memList, allocatedBlock);
+}
+
+#endif
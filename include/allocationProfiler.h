@@ -0,0 +1,406 @@
+#ifndef ALLOCATIONPROFILER
+#define ALLOCATIONPROFILER
+
+#include <string.h>
+#include <time.h>
+#include "memorySegment.h"
+#include "dynamicMemoryManagement.h"
+
+/**
+ * Sampling profiler of the assign and reclaim paths. One in every samplingRate requests is sampled: its size class,
+ * its caller tag, the free block it split and its lifetime, in operations and nanoseconds, are recorded. Requests that
+ * are not sampled only decrement a counter, which keeps the overhead low. A large split whose block turns out to be
+ * long-lived is counted apart, since it keeps the large free block it came from split for a long time.
+ */
+
+#define SizeClasses 17
+#define MaxCallerTags 64
+#define MaxSampledBlocks 1024
+#define DefaultSamplingRate 64
+#define LargeSegmentLength 1024
+#define LongLivedOperations 10000
+#define ProfileFormatVersion 2
+
+typedef struct sizeClassProfile {
+    uint64_t samples;
+    uint64_t largeSplits;
+    uint64_t splitMemory;
+    uint64_t reclaimed;
+    uint64_t lifetimeOperations;
+    uint64_t lifetimeNanoseconds;
+    uint64_t longLived;
+    uint64_t longLivedSplits;
+} sizeClassProfile;
+
+typedef struct callerProfile {
+    uint64_t samples;
+    uint64_t largeSplits;
+    uint64_t splitMemory;
+    uint64_t longLivedSplits;
+} callerProfile;
+
+/**
+ * A sampled block, which is live until it is reclaimed.
+ */
+typedef struct allocationSample {
+    uint16_t startAddress;
+    uint16_t requestedMem;
+    uint16_t callerTag;
+    uint16_t splitLength;
+    uint64_t assignedAtOperation;
+    uint64_t assignedAtNanoseconds;
+    bool live;
+} allocationSample;
+
+typedef struct allocationProfiler {
+    bool enabled;
+    uint32_t samplingRate;
+    uint32_t countdown;
+    uint64_t operations;
+    sizeClassProfile classes[SizeClasses];
+    callerProfile callers[MaxCallerTags];
+    allocationSample samples[MaxSampledBlocks];
+    uint64_t sampledAddresses[(UINT16_MAX + 1) / 64];
+    uint32_t droppedSamples;
+} allocationProfiler;
+
+static allocationProfiler profilerState;
+
+uint64_t profilerNanoseconds() {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000ull + now.tv_nsec;
+}
+
+/**
+ * The size class of a request is the number of bits needed to represent it.
+ */
+int sizeClassOf(uint16_t requestedMem) {
+    return requestedMem == 0 ? 0 : 32 - __builtin_clz(requestedMem);
+}
+
+/**
+ * Resets and enables the profiler.
+ *
+ * @param samplingRate one in every samplingRate requests is sampled.
+ */
+void initializeProfiler(uint32_t samplingRate) {
+    memset(&profilerState, 0, sizeof(profilerState));
+    profilerState.enabled = true;
+    profilerState.samplingRate = samplingRate > 0 ? samplingRate : DefaultSamplingRate;
+    profilerState.countdown = profilerState.samplingRate;
+}
+
+/**
+ * Records a sampled request.
+ *
+ * @param allocatedBlock the memory block that was allocated, or NULL if the request failed.
+ * @param requestedMem the memory requested by a process.
+ * @param callerTag identifies the caller that requested the memory.
+ * @param splitLength the length of the free block that was split to serve the request, or 0 if it fitted exactly.
+ */
+void sampleAssign(memorySegment *allocatedBlock, uint16_t requestedMem, uint16_t callerTag, uint16_t splitLength) {
+    int sizeClass = sizeClassOf(requestedMem);
+    callerTag %= MaxCallerTags;
+    profilerState.classes[sizeClass].samples++;
+    profilerState.callers[callerTag].samples++;
+    if (allocatedBlock == NULL) {
+        return;
+    }
+
+    if (splitLength > 0) {
+        profilerState.classes[sizeClass].splitMemory += splitLength;
+        profilerState.callers[callerTag].splitMemory += splitLength;
+        if (splitLength >= LargeSegmentLength) {
+            profilerState.classes[sizeClass].largeSplits++;
+            profilerState.callers[callerTag].largeSplits++;
+        }
+    }
+
+    for (int i = 0; i < MaxSampledBlocks; i++) {
+        if (!profilerState.samples[i].live) {
+            allocationSample *sample = &profilerState.samples[i];
+            sample->startAddress = allocatedBlock->startAddress;
+            sample->requestedMem = requestedMem;
+            sample->callerTag = callerTag;
+            sample->splitLength = splitLength;
+            sample->assignedAtOperation = profilerState.operations;
+            sample->assignedAtNanoseconds = profilerNanoseconds();
+            sample->live = true;
+            profilerState.sampledAddresses[sample->startAddress / 64] |= 1ull << (sample->startAddress % 64);
+            return;
+        }
+    }
+    profilerState.droppedSamples++;
+}
+
+void sampleReclaim(uint16_t startAddress) {
+    profilerState.sampledAddresses[startAddress / 64] &= ~(1ull << (startAddress % 64));
+    for (int i = 0; i < MaxSampledBlocks; i++) {
+        allocationSample *sample = &profilerState.samples[i];
+        if (sample->live && sample->startAddress == startAddress) {
+            sizeClassProfile *profile = &profilerState.classes[sizeClassOf(sample->requestedMem)];
+            uint64_t lifetime = profilerState.operations - sample->assignedAtOperation;
+            profile->reclaimed++;
+            profile->lifetimeOperations += lifetime;
+            profile->lifetimeNanoseconds += profilerNanoseconds() - sample->assignedAtNanoseconds;
+            if (lifetime >= LongLivedOperations) {
+                profile->longLived++;
+                if (sample->splitLength >= LargeSegmentLength) {
+                    profile->longLivedSplits++;
+                    profilerState.callers[sample->callerTag].longLivedSplits++;
+                }
+            }
+            sample->live = false;
+            return;
+        }
+    }
+}
+
+/**
+ * Assigns the requested memory with the given method, sampling the request.
+ *
+ * @param assignMemory the method of assignement.
+ * @param memList the memory as a linked list, with each node representing a memory block.
+ * @param requestedMem the memory requested by a process.
+ * @param callerTag identifies the caller that requested the memory.
+ * @return memorySegment* the memory block that was allocated by the memory management service.
+ */
+memorySegment *assignProfiled(memorySegment *(*assignMemory)(memorySegment *mem, uint16_t size),
+                              memorySegment *memList, uint16_t requestedMem, uint16_t callerTag) {
+    if (!profilerState.enabled) {
+        return (*assignMemory)(memList, requestedMem);
+    }
+    profilerState.operations++;
+    if (--profilerState.countdown != 0) {
+        return (*assignMemory)(memList, requestedMem);
+    }
+    profilerState.countdown = profilerState.samplingRate;
+
+    /* the method records the length of the block it splits before the split, and nothing on an exact fit */
+    splitBlockLength = 0;
+    memorySegment *allocatedBlock = (*assignMemory)(memList, requestedMem);
+    sampleAssign(allocatedBlock, requestedMem, callerTag, splitBlockLength);
+    return allocatedBlock;
+}
+
+/**
+ * Reclaims the memory block with the given method, completing its sample if it was sampled.
+ *
+ * @param reclaimMemory the method of reclaim.
+ * @param memList the memory as a linked list, with each node representing a memory block.
+ * @param thisOne the memory block to reclaim.
+ */
+void reclaimProfiled(void (*reclaimMemory)(memorySegment *mem, memorySegment *thisOne),
+                     memorySegment *memList, memorySegment *thisOne) {
+    uint16_t startAddress = thisOne->startAddress;
+    (*reclaimMemory)(memList, thisOne);
+    if (!profilerState.enabled) {
+        return;
+    }
+    profilerState.operations++;
+    if (profilerState.sampledAddresses[startAddress / 64] & (1ull << (startAddress % 64))) {
+        sampleReclaim(startAddress);
+    }
+}
+
+/**
+ * Adds the sampled blocks that are still live, but already old enough to be long-lived, to copies of the tables.
+ */
+void addLiveLongLived(sizeClassProfile *classes, callerProfile *callers) {
+    memcpy(classes, profilerState.classes, sizeof(profilerState.classes));
+    memcpy(callers, profilerState.callers, sizeof(profilerState.callers));
+    for (int i = 0; i < MaxSampledBlocks; i++) {
+        allocationSample *sample = &profilerState.samples[i];
+        if (!sample->live || profilerState.operations - sample->assignedAtOperation < LongLivedOperations) {
+            continue;
+        }
+        sizeClassProfile *profile = &classes[sizeClassOf(sample->requestedMem)];
+        profile->longLived++;
+        if (sample->splitLength >= LargeSegmentLength) {
+            profile->longLivedSplits++;
+            callers[sample->callerTag].longLivedSplits++;
+        }
+    }
+}
+
+bool writeProfileNumber(FILE *file, uint64_t value, int bytes) {
+    unsigned char buffer[8];
+    for (int i = 0; i < bytes; i++) {
+        buffer[i] = (unsigned char)(value >> (8 * i));
+    }
+    return fwrite(buffer, bytes, 1, file) == 1;
+}
+
+bool readProfileNumber(FILE *file, uint64_t *value, int bytes) {
+    unsigned char buffer[8];
+    if (fread(buffer, bytes, 1, file) != 1) {
+        return false;
+    }
+    *value = 0;
+    for (int i = 0; i < bytes; i++) {
+        *value |= (uint64_t)buffer[i] << (8 * i);
+    }
+    return true;
+}
+
+/**
+ * Writes the profile in a compact binary form, independent of the layout of the structs: the 8 bytes "MMPROFIL", the
+ * format version, the sampling rate, the number of operations and of dropped samples, then the number of size classes
+ * that were sampled and one entry for each, and the same for the caller tags. A size class entry is its index and its
+ * eight counters, and a caller entry is its tag and its four counters. Numbers are little endian, of 1, 2, 4 or 8
+ * bytes, and the long-lived counters include the sampled blocks that are still live.
+ *
+ * @param path the file to write.
+ * @return int 0 on success, -1 if the file could not be written.
+ */
+int writeProfile(const char *path) {
+    FILE *file = fopen(path, "wb");
+    if (file == NULL) {
+        return -1;
+    }
+    sizeClassProfile classes[SizeClasses];
+    callerProfile callers[MaxCallerTags];
+    addLiveLongLived(classes, callers);
+    uint64_t sampledClasses = 0, sampledCallers = 0;
+    for (int i = 0; i < SizeClasses; i++) {
+        sampledClasses += classes[i].samples > 0;
+    }
+    for (int i = 0; i < MaxCallerTags; i++) {
+        sampledCallers += callers[i].samples > 0;
+    }
+
+    bool written = fwrite("MMPROFIL", 8, 1, file) == 1 && writeProfileNumber(file, ProfileFormatVersion, 4) &&
+                   writeProfileNumber(file, profilerState.samplingRate, 4) &&
+                   writeProfileNumber(file, profilerState.operations, 8) &&
+                   writeProfileNumber(file, profilerState.droppedSamples, 4) &&
+                   writeProfileNumber(file, sampledClasses, 4);
+    for (int i = 0; written && i < SizeClasses; i++) {
+        sizeClassProfile *profile = &classes[i];
+        if (profile->samples == 0) {
+            continue;
+        }
+        written = writeProfileNumber(file, i, 1) && writeProfileNumber(file, profile->samples, 8) &&
+                  writeProfileNumber(file, profile->largeSplits, 8) &&
+                  writeProfileNumber(file, profile->splitMemory, 8) &&
+                  writeProfileNumber(file, profile->reclaimed, 8) &&
+                  writeProfileNumber(file, profile->lifetimeOperations, 8) &&
+                  writeProfileNumber(file, profile->lifetimeNanoseconds, 8) &&
+                  writeProfileNumber(file, profile->longLived, 8) &&
+                  writeProfileNumber(file, profile->longLivedSplits, 8);
+    }
+    written = written && writeProfileNumber(file, sampledCallers, 4);
+    for (int i = 0; written && i < MaxCallerTags; i++) {
+        callerProfile *profile = &callers[i];
+        if (profile->samples == 0) {
+            continue;
+        }
+        written = writeProfileNumber(file, i, 2) && writeProfileNumber(file, profile->samples, 8) &&
+                  writeProfileNumber(file, profile->largeSplits, 8) &&
+                  writeProfileNumber(file, profile->splitMemory, 8) &&
+                  writeProfileNumber(file, profile->longLivedSplits, 8);
+    }
+    written = fclose(file) == 0 && written;
+    return written ? 0 : -1;
+}
+
+/**
+ * Reads a profile written by writeProfile. The sampled blocks are not part of the file, so the profile read has none.
+ *
+ * @param path the file to read.
+ * @param profile filled with the sampling rate, the number of operations and of dropped samples, and the tables.
+ * @return int 0 on success, -1 if the file could not be read or is not a profile of this version.
+ */
+int readProfile(const char *path, allocationProfiler *profile) {
+    FILE *file = fopen(path, "rb");
+    if (file == NULL) {
+        return -1;
+    }
+    memset(profile, 0, sizeof(*profile));
+    char magic[8];
+    uint64_t version, value = 0, entries, index;
+    bool read = fread(magic, 8, 1, file) == 1 && memcmp(magic, "MMPROFIL", 8) == 0 &&
+                readProfileNumber(file, &version, 4) && version == ProfileFormatVersion &&
+                readProfileNumber(file, &value, 4);
+    profile->samplingRate = (uint32_t)value;
+    read = read && readProfileNumber(file, &profile->operations, 8) && readProfileNumber(file, &value, 4);
+    profile->droppedSamples = (uint32_t)value;
+    read = read && readProfileNumber(file, &entries, 4);
+    for (uint64_t i = 0; read && i < entries; i++) {
+        read = readProfileNumber(file, &index, 1) && index < SizeClasses;
+        sizeClassProfile *entry = &profile->classes[read ? index : 0];
+        read = read && readProfileNumber(file, &entry->samples, 8) && readProfileNumber(file, &entry->largeSplits, 8) &&
+               readProfileNumber(file, &entry->splitMemory, 8) && readProfileNumber(file, &entry->reclaimed, 8) &&
+               readProfileNumber(file, &entry->lifetimeOperations, 8) &&
+               readProfileNumber(file, &entry->lifetimeNanoseconds, 8) &&
+               readProfileNumber(file, &entry->longLived, 8) && readProfileNumber(file, &entry->longLivedSplits, 8);
+    }
+    read = read && readProfileNumber(file, &entries, 4);
+    for (uint64_t i = 0; read && i < entries; i++) {
+        read = readProfileNumber(file, &index, 2) && index < MaxCallerTags;
+        callerProfile *entry = &profile->callers[read ? index : 0];
+        read = read && readProfileNumber(file, &entry->samples, 8) && readProfileNumber(file, &entry->largeSplits, 8) &&
+               readProfileNumber(file, &entry->splitMemory, 8) && readProfileNumber(file, &entry->longLivedSplits, 8);
+    }
+    fclose(file);
+    return read ? 0 : -1;
+}
+
+/**
+ * Prints the size classes and the caller tags ordered by the number of large free blocks their requests split, along
+ * with the lifetimes of the sampled blocks, and how many of the large splits were made by long-lived blocks. Blocks
+ * that are still live count as long-lived once they are old enough.
+ *
+ * @param output the stream where the report is written.
+ */
+void printProfileReport(FILE *output) {
+    sizeClassProfile classes[SizeClasses];
+    callerProfile callers[MaxCallerTags];
+    addLiveLongLived(classes, callers);
+
+    int order[SizeClasses];
+    for (int i = 0; i < SizeClasses; i++) {
+        order[i] = i;
+    }
+    for (int i = 1; i < SizeClasses; i++) {
+        for (int j = i; j > 0 && classes[order[j]].largeSplits > classes[order[j - 1]].largeSplits; j--) {
+            int swap = order[j];
+            order[j] = order[j - 1];
+            order[j - 1] = swap;
+        }
+    }
+
+    fprintf(output, "operations %llu, sampling 1/%u, dropped samples %u\n",
+            (unsigned long long)profilerState.operations, profilerState.samplingRate, profilerState.droppedSamples);
+    fprintf(output, "%-13s %9s %12s %12s %12s %14s %10s %11s\n", "size class", "samples", "large splits",
+            "split mem", "lifetime ops", "lifetime ns", "long-lived", "long splits");
+    for (int i = 0; i < SizeClasses; i++) {
+        sizeClassProfile *profile = &classes[order[i]];
+        if (profile->samples == 0) {
+            continue;
+        }
+        int low = order[i] == 0 ? 0 : 1 << (order[i] - 1);
+        int high = order[i] == 0 ? 0 : (1 << order[i]) - 1;
+        char range[16];
+        snprintf(range, sizeof(range), "%d-%d", low, high);
+        fprintf(output, "%-13s %9llu %12llu %12llu %12.1f %14.1f %10llu %11llu\n", range,
+                (unsigned long long)profile->samples, (unsigned long long)profile->largeSplits,
+                (unsigned long long)profile->splitMemory,
+                profile->reclaimed ? (double)profile->lifetimeOperations / profile->reclaimed : 0.0,
+                profile->reclaimed ? (double)profile->lifetimeNanoseconds / profile->reclaimed : 0.0,
+                (unsigned long long)profile->longLived, (unsigned long long)profile->longLivedSplits);
+    }
+
+    fprintf(output, "%-13s %9s %12s %12s %11s\n", "caller tag", "samples", "large splits", "split mem", "long splits");
+    for (int i = 0; i < MaxCallerTags; i++) {
+        callerProfile *profile = &callers[i];
+        if (profile->samples == 0) {
+            continue;
+        }
+        fprintf(output, "%-13d %9llu %12llu %12llu %11llu\n", i, (unsigned long long)profile->samples,
+                (unsigned long long)profile->largeSplits, (unsigned long long)profile->splitMemory,
+                (unsigned long long)profile->longLivedSplits);
+    }
+}
+
+#endif
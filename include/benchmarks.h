@@ -0,0 +1,820 @@
+#ifndef BENCHMARKS
+#define BENCHMARKS
+
+#include <malloc.h>
+#include <time.h>
+#include <linux/perf_event.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include "memorySegment.h"
+#include "staticMemoryManagement.h"
+#include "staticBitmap.h"
+#include "dynamicMemoryManagement.h"
+#include "adaptivePolicy.h"
+#include "allocationProfiler.h"
+#include "traceRecorder.h"
+#include "vectorizedBestFit.h"
+#include "tester.h"
+
+/**
+ * Benchmarks that replay synthetic allocation traces through the memory management methods, and report their
+ * throughput and fragmentation.
+ */
+void benchmark_alignedPaddingWaste();
+void benchmark_inPlaceResize();
+void benchmark_adaptivePolicy();
+void benchmark_allocationProfiler();
+void benchmark_traceRecorder();
+void benchmark_staticBitmap();
+void benchmark_vectorizedBestFit();
+void benchmark_largeObjects();
+void benchmark_scavenger();
+
+#define BenchmarkMemorySize UINT16_MAX
+#define BenchmarkMaxLiveBlocks 512
+#define KernelRepetitions 8
+
+/**
+ * Deterministic xorshift generator, so that every method replays exactly the same trace.
+ */
+uint32_t nextRandom(uint32_t *state) {
+    uint32_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return x;
+}
+
+double elapsedSeconds(struct timespec *start) {
+    struct timespec end;
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    return (end.tv_sec - start->tv_sec) + (end.tv_nsec - start->tv_nsec) / 1e9;
+}
+
+/**
+ * Counts the free memory blocks of the memory, and the length of the largest one.
+ */
+uint32_t countFreeSegments(memorySegment *memList, uint16_t *largestFree) {
+    uint32_t freeSegments = 0;
+    *largestFree = 0;
+    while (memList != NULL) {
+        if (!memList->occupied) {
+            freeSegments++;
+            if (memList->length > *largestFree) {
+                *largestFree = memList->length;
+            }
+        }
+        memList = memList->next;
+    }
+    return freeSegments;
+}
+
+/**
+ * Sums the free memory that no request at the given alignment can use: the free blocks without an aligned address,
+ * like the leading padding left before an aligned block. Padding that was coalesced back into a larger free block, or
+ * reused, is not counted.
+ */
+uint32_t strandedPadding(memorySegment *memList, uint16_t alignment) {
+    uint32_t stranded = 0;
+    while (memList != NULL) {
+        if (!memList->occupied && alignmentPadding(memList, alignment) >= memList->length) {
+            stranded += memList->length;
+        }
+        memList = memList->next;
+    }
+    return stranded;
+}
+
+void benchmark_alignedPaddingWaste() {
+    printf("\n========================= ALIGNED PADDING WASTE =========================\n\n");
+    const char *methodNames[3] = {"AF", "AB", "AN"};
+    memorySegment *(*methods[3]) (memorySegment *memList, uint16_t requestedMem, uint16_t alignment) = {
+        assignFirstAlignedDyn, assignBestAlignedDyn, assignNextAlignedDyn
+    };
+    uint16_t alignments[4] = {1, 8, 64, 512};
+    const int operations = 20000;
+
+    printf("%-6s %-6s %10s %9s %10s %10s %9s %9s\n", "align", "method", "assigned", "failed", "liveMem", "padding",
+           "waste%", "freeSegs");
+    for (int a = 0; a < 4; a++) {
+        for (int m = 0; m < 3; m++) {
+            memorySegment *memList = initializeDynamicMemory(BenchmarkMemorySize);
+            memorySegment *live[BenchmarkMaxLiveBlocks];
+            int liveBlocks = 0;
+            uint32_t seed = 2463534242u;
+            uint32_t assigned = 0, failed = 0;
+            lastAllocatedBlock = NULL;
+
+            for (int op = 0; op < operations; op++) {
+                uint32_t r = nextRandom(&seed);
+                if (liveBlocks == 0 || (liveBlocks < BenchmarkMaxLiveBlocks && r % 3 != 0)) {
+                    uint16_t size = 1 + nextRandom(&seed) % 256;
+                    memorySegment *block = (*methods[m])(memList, size, alignments[a]);
+                    if (block == NULL) {
+                        failed++;
+                        continue;
+                    }
+                    live[liveBlocks++] = block;
+                    assigned++;
+                } else {
+                    int victim = nextRandom(&seed) % liveBlocks;
+                    reclaimDyn(memList, live[victim]);
+                    live[victim] = live[--liveBlocks];
+                }
+            }
+
+            /* the padding that is still wasted at the end, against the memory of the blocks that are still live */
+            uint32_t liveMemory = 0;
+            for (int i = 0; i < liveBlocks; i++) {
+                liveMemory += live[i]->length;
+            }
+            uint32_t padding = strandedPadding(memList, alignments[a]);
+            uint16_t largestFree;
+            uint32_t freeSegments = countFreeSegments(memList, &largestFree);
+            printf("%-6d %-6s %10u %9u %10u %10u %8.2f%% %9u\n", alignments[a], methodNames[m], assigned, failed,
+                   liveMemory, padding, liveMemory ? 100.0 * padding / liveMemory : 0.0, freeSegments);
+        }
+    }
+}
+
+void benchmark_inPlaceResize() {
+    printf("\n========================= IN-PLACE RESIZE =========================\n\n");
+    const char *methodNames[3] = {"AF", "AB", "AN"};
+    memorySegment *(*methods[3]) (memorySegment *memList, uint16_t requestedMem) = {
+        assignFirstDyn, assignBestDyn, assignNextDyn
+    };
+    const int operations = 50000;
+
+    printf("%-6s %9s %9s %9s %9s %9s %10s\n", "method", "resizes", "grown", "shrunk", "relocated", "failed",
+           "inPlace%");
+    for (int m = 0; m < 3; m++) {
+        memorySegment *memList = initializeDynamicMemory(BenchmarkMemorySize);
+        memorySegment *live[BenchmarkMaxLiveBlocks];
+        int liveBlocks = 0;
+        uint32_t seed = 88675123u;
+        lastAllocatedBlock = NULL;
+        resizeStats = (resizeStatistics){0, 0, 0, 0};
+
+        /* growth-heavy trace: most operations append to a live block, as a growing buffer would */
+        for (int op = 0; op < operations; op++) {
+            uint32_t r = nextRandom(&seed) % 100;
+            if (liveBlocks == 0 || (r < 15 && liveBlocks < BenchmarkMaxLiveBlocks / 2)) {
+                memorySegment *block = (*methods[m])(memList, 8 + nextRandom(&seed) % 57);
+                if (block != NULL) {
+                    live[liveBlocks++] = block;
+                }
+                continue;
+            }
+            int victim = nextRandom(&seed) % liveBlocks;
+            uint16_t length = live[victim]->length;
+            if (r < 30 || length > 2048) {
+                reclaimDyn(memList, live[victim]);
+                live[victim] = live[--liveBlocks];
+            } else if (r < 40) {
+                memorySegment *block = resizeDyn(memList, live[victim], length / 2 + 1, methods[m]);
+                live[victim] = block;
+            } else {
+                memorySegment *block = resizeDyn(memList, live[victim], length + 1 + nextRandom(&seed) % 64,
+                                                 methods[m]);
+                if (block != NULL) {
+                    live[victim] = block;
+                }
+            }
+        }
+
+        uint32_t resizes = resizeStats.grownInPlace + resizeStats.shrunkInPlace + resizeStats.relocated +
+                           resizeStats.failed;
+        printf("%-6s %9u %9u %9u %9u %9u %9.2f%%\n", methodNames[m], resizes, resizeStats.grownInPlace,
+               resizeStats.shrunkInPlace, resizeStats.relocated, resizeStats.failed,
+               resizes ? 100.0 * (resizeStats.grownInPlace + resizeStats.shrunkInPlace) / resizes : 0.0);
+    }
+}
+
+void benchmark_adaptivePolicy() {
+    printf("\n========================= ADAPTIVE METHOD =========================\n\n");
+    const char *methodNames[4] = {"AF", "AB", "AN", "AA"};
+    memorySegment *(*methods[4]) (memorySegment *memList, uint16_t requestedMem) = {
+        assignFirstDyn, assignBestDyn, assignNextDyn, assignAdaptiveDyn
+    };
+    const int operations = 200000;
+    const int phaseLength = 20000;
+    uint32_t failures[4];
+    uint64_t visits[4];
+
+    printf("%-6s %9s %9s %12s %10s %9s\n", "method", "assigned", "failed", "visited", "time(ms)", "switches");
+    for (int m = 0; m < 4; m++) {
+        memorySegment *memList = initializeDynamicMemory(BenchmarkMemorySize);
+        memorySegment *live[BenchmarkMaxLiveBlocks];
+        int liveBlocks = 0;
+        uint32_t seed = 521288629u;
+        uint32_t assigned = 0, failed = 0;
+        lastAllocatedBlock = NULL;
+        initializeAdaptivePolicy(DefaultEpochLength, NULL);
+        uint64_t visitedAtStart = segmentsVisited;
+        struct timespec start;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+
+        /* mixed trace: phases of small-object churn alternate with phases of few, large buffers */
+        for (int op = 0; op < operations; op++) {
+            bool largeBuffers = (op / phaseLength) % 2 == 1;
+            int liveLimit = largeBuffers ? 24 : BenchmarkMaxLiveBlocks;
+            uint32_t r = nextRandom(&seed) % 100;
+            if (liveBlocks == 0 || (liveBlocks < liveLimit && r < 55)) {
+                uint16_t size = largeBuffers ? 512 + nextRandom(&seed) % 3584 : 1 + nextRandom(&seed) % 48;
+                memorySegment *block = (*methods[m])(memList, size);
+                if (block == NULL) {
+                    failed++;
+                    continue;
+                }
+                live[liveBlocks++] = block;
+                assigned++;
+            } else {
+                int victim = nextRandom(&seed) % liveBlocks;
+                reclaimDyn(memList, live[victim]);
+                live[victim] = live[--liveBlocks];
+            }
+        }
+
+        failures[m] = failed;
+        visits[m] = segmentsVisited - visitedAtStart;
+        printf("%-6s %9u %9u %12llu %10.2f %9u\n", methodNames[m], assigned, failed, (unsigned long long)visits[m],
+               1000.0 * elapsedSeconds(&start), m == 3 ? adaptiveState.switches : 0);
+    }
+
+    int best = 0;
+    for (int m = 1; m < 3; m++) {
+        if (failures[m] < failures[best]) {
+            best = m;
+        }
+    }
+    printf("\nAA against %s, the fixed method with the fewest failures: %+.1f%% failures, %.0f%% of the visits\n",
+           methodNames[best], 100.0 * ((double)failures[3] / failures[best] - 1.0), 100.0 * visits[3] / visits[best]);
+}
+
+/**
+ * Replays a churn trace, tagging each request with one of a few callers, through the profiled or the plain paths.
+ */
+double replayProfilerTrace(bool profiled, int operations) {
+    memorySegment *memList = initializeDynamicMemory(BenchmarkMemorySize);
+    memorySegment *live[BenchmarkMaxLiveBlocks];
+    int liveBlocks = 0;
+    uint32_t seed = 1234567u;
+    struct timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    for (int op = 0; op < operations; op++) {
+        uint32_t r = nextRandom(&seed);
+        if (liveBlocks == 0 || (liveBlocks < BenchmarkMaxLiveBlocks && r % 2 == 0)) {
+            uint16_t callerTag = nextRandom(&seed) % 8;
+            /* caller 7 requests large, long-lived buffers, the others small objects */
+            uint16_t size = callerTag == 7 ? 256 + nextRandom(&seed) % 1024 : 1 + nextRandom(&seed) % (16 << callerTag);
+            memorySegment *block = profiled ? assignProfiled(assignFirstDyn, memList, size, callerTag)
+                                            : assignFirstDyn(memList, size);
+            if (block != NULL) {
+                live[liveBlocks++] = block;
+            }
+        } else {
+            int victim = nextRandom(&seed) % liveBlocks;
+            if (live[victim]->length >= 256 && nextRandom(&seed) % 8 != 0) {
+                continue;
+            }
+            if (profiled) {
+                reclaimProfiled(reclaimDyn, memList, live[victim]);
+            } else {
+                reclaimDyn(memList, live[victim]);
+            }
+            live[victim] = live[--liveBlocks];
+        }
+    }
+    return elapsedSeconds(&start);
+}
+
+void benchmark_allocationProfiler() {
+    printf("\n========================= ALLOCATION PROFILER =========================\n\n");
+    const int operations = 400000;
+    const int repetitions = 9;
+    double plain = 1e9, plainAgain = 1e9, profiled = 1e9;
+
+    /* the runs are interleaved, and the fastest of each kind is kept; two plain runs per round show how much of the
+       difference is noise */
+    for (int i = 0; i < repetitions; i++) {
+        profilerState.enabled = false;
+        double seconds = replayProfilerTrace(false, operations);
+        plain = seconds < plain ? seconds : plain;
+        initializeProfiler(DefaultSamplingRate);
+        seconds = replayProfilerTrace(true, operations);
+        profiled = seconds < profiled ? seconds : profiled;
+        bool enabled = profilerState.enabled;
+        profilerState.enabled = false;
+        seconds = replayProfilerTrace(false, operations);
+        plainAgain = seconds < plainAgain ? seconds : plainAgain;
+        profilerState.enabled = enabled;
+    }
+
+    printf("plain %.2f ms, profiled %.2f ms, overhead %.2f%% at sampling 1/%d\n", 1000.0 * plain, 1000.0 * profiled,
+           100.0 * (profiled - plain) / plain, DefaultSamplingRate);
+    double noise = plainAgain > plain ? plainAgain - plain : plain - plainAgain;
+    printf("noise floor, plain against plain: %.2f%%\n\n", 100.0 * noise / plain);
+    printProfileReport(stdout);
+    char path[PATH_MAX];
+    if (temporaryPath(path, sizeof(path), "allocationProfile.bin") == 0 && writeProfile(path) == 0) {
+        struct stat status;
+        stat(path, &status);
+        printf("\nProfile written in %lld bytes\n", (long long)status.st_size);
+        unlink(path);
+    }
+    profilerState.enabled = false;
+}
+
+/**
+ * Replays a churn trace through First Fit, recording every assigned and reclaimed block when asked to. Each assigned
+ * block gets a new id, starting from firstId. Returns the CPU time of the calling thread, which excludes the work of
+ * the background thread of the recorder.
+ */
+double replayRecorderTrace(bool recorded, int operations, uint32_t seed, uint64_t firstId) {
+    memorySegment *memList = initializeDynamicMemory(BenchmarkMemorySize);
+    memorySegment *live[BenchmarkMaxLiveBlocks];
+    uint64_t ids[BenchmarkMaxLiveBlocks];
+    int liveBlocks = 0;
+    uint64_t nextId = firstId;
+    struct timespec start, end;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+
+    for (int op = 0; op < operations; op++) {
+        uint32_t r = nextRandom(&seed);
+        if (liveBlocks == 0 || (liveBlocks < BenchmarkMaxLiveBlocks && r % 2 == 0)) {
+            uint16_t size = 1 + nextRandom(&seed) % 256;
+            memorySegment *block = assignFirstDyn(memList, size);
+            if (block != NULL) {
+                if (recorded) {
+                    recordAssign(nextId, size);
+                }
+                ids[liveBlocks] = nextId++;
+                live[liveBlocks++] = block;
+            }
+        } else {
+            int victim = nextRandom(&seed) % liveBlocks;
+            if (recorded) {
+                recordReclaim(ids[victim]);
+            }
+            reclaimDyn(memList, live[victim]);
+            ids[victim] = ids[liveBlocks - 1];
+            live[victim] = live[--liveBlocks];
+        }
+    }
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+    freeList(memList);
+    return (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+}
+
+void *recorderWorker(void *argument) {
+    uint64_t worker = (uint64_t)(uintptr_t)argument;
+    replayRecorderTrace(true, 200000, 7654321u + (uint32_t)worker, worker << 32);
+    return NULL;
+}
+
+void benchmark_traceRecorder() {
+    printf("\n========================= TRACE RECORDER =========================\n\n");
+    const int operations = 400000;
+    const int repetitions = 7;
+    double plain = 1e9, recorded = 1e9, plainWall = 1e9, recordedWall = 1e9;
+    struct timespec start;
+
+    char path[PATH_MAX];
+    if (temporaryPath(path, sizeof(path), "recorded.trace") != 0 || startTraceRecorder(path) != 0) {
+        printf("Could not create a temporary trace\n");
+        return;
+    }
+    /* the runs are interleaved, and the fastest of each kind is kept, which filters out the noise of other processes */
+    for (int i = 0; i < repetitions; i++) {
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        double seconds = replayRecorderTrace(false, operations, 1234567u, 0);
+        double wallSeconds = elapsedSeconds(&start);
+        plain = seconds < plain ? seconds : plain;
+        plainWall = wallSeconds < plainWall ? wallSeconds : plainWall;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        seconds = replayRecorderTrace(true, operations, 1234567u, 0);
+        wallSeconds = elapsedSeconds(&start);
+        recorded = seconds < recorded ? seconds : recorded;
+        recordedWall = wallSeconds < recordedWall ? wallSeconds : recordedWall;
+    }
+    stopTraceRecorder();
+    printf("recording thread: plain %.2f ms, recorded %.2f ms, overhead %.2f%%\n", 1000.0 * plain,
+           1000.0 * recorded, 100.0 * (recorded - plain) / plain);
+    printf("wall clock, with the background thread: plain %.2f ms, recorded %.2f ms, overhead %.2f%%\n",
+           1000.0 * plainWall, 1000.0 * recordedWall, 100.0 * (recordedWall - plainWall) / plainWall);
+    printf("%llu events in %llu bytes (%.2f bytes per event)\n", (unsigned long long)recorderState.events,
+           (unsigned long long)recorderState.bytes, (double)recorderState.bytes / recorderState.events);
+
+    /* two threads record disjoint ids into the same trace, which is merged by timestamp when it is replayed */
+    startTraceRecorder(path);
+    pthread_t workers[2];
+    for (uint64_t i = 0; i < 2; i++) {
+        pthread_create(&workers[i], NULL, recorderWorker, (void *)(uintptr_t)i);
+    }
+    for (int i = 0; i < 2; i++) {
+        pthread_join(workers[i], NULL);
+    }
+    stopTraceRecorder();
+    printf("\nReplay of the trace recorded by 2 threads:\n");
+    replayRecorded(path, 1);
+    unlink(path);
+}
+
+/**
+ * Fills 90% of the bitmap from the start, and then frees 1% of its blocks at random, which leaves holes of single
+ * blocks spread over the occupied part.
+ */
+void fillStaticBitmap(staticBitmap *bitmap, uint32_t *seed) {
+    uint64_t filled = bitmap->blockCount / 10 * 9;
+    markBlocks(bitmap, 0, filled, true);
+    for (uint64_t i = 0; i < bitmap->blockCount / 100; i++) {
+        uint64_t block = (((uint64_t)nextRandom(seed) << 32) | nextRandom(seed)) % filled;
+        if ((bitmap->levels[0][block / 64] & (1ull << (block % 64))) == 0) {
+            reclaimBitmap(bitmap, block, bitmap->blockSize);
+        }
+    }
+}
+
+/**
+ * Churns a bitmap: each operation reclaims a random live run and assigns a new one of 1 to maxBlocks blocks.
+ */
+double churnStaticBitmap(staticBitmap *bitmap, uint64_t (*assignMemory)(staticBitmap *bitmap, uint64_t size),
+                         uint64_t maxBlocks, int operations, uint32_t *seed, uint32_t *failed) {
+    uint64_t liveStart[BenchmarkMaxLiveBlocks];
+    uint64_t liveSize[BenchmarkMaxLiveBlocks];
+    for (int i = 0; i < BenchmarkMaxLiveBlocks; i++) {
+        liveSize[i] = (1 + nextRandom(seed) % maxBlocks) * bitmap->blockSize;
+        liveStart[i] = (*assignMemory)(bitmap, liveSize[i]);
+    }
+    struct timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int op = 0; op < operations; op++) {
+        int victim = nextRandom(seed) % BenchmarkMaxLiveBlocks;
+        if (liveStart[victim] != NoFreeBlock) {
+            reclaimBitmap(bitmap, liveStart[victim], liveSize[victim]);
+        }
+        liveSize[victim] = (1 + nextRandom(seed) % maxBlocks) * bitmap->blockSize;
+        liveStart[victim] = (*assignMemory)(bitmap, liveSize[victim]);
+        if (liveStart[victim] == NoFreeBlock) {
+            (*failed)++;
+        }
+    }
+    return elapsedSeconds(&start);
+}
+
+void benchmark_staticBitmap() {
+    printf("\n========================= STATIC BITMAP =========================\n\n");
+    const uint64_t blockCounts[2] = {1ull << 20, 1ull << 26};
+    const int operations = 1000000;
+
+    /* the list is only timed at 1M blocks, where each of its searches already walks most of the memory */
+    const int listOperations = 2000;
+    memorySegment *memList = initializeStaticMemory(1 << 20, 1);
+    memorySegment **blocks = (memorySegment **)malloc(sizeof(memorySegment *) << 20);
+    int index = 0;
+    for (memorySegment *currentSegment = memList; currentSegment != NULL; currentSegment = currentSegment->next) {
+        currentSegment->occupied = index < (1 << 20) / 10 * 9;
+        blocks[index++] = currentSegment;
+    }
+    uint32_t seed = 88172645u;
+    for (int i = 0; i < (1 << 20) / 100; i++) {
+        blocks[nextRandom(&seed) % ((1 << 20) / 10 * 9)]->occupied = false;
+    }
+    struct timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int op = 0; op < listOperations; op++) {
+        blocks[nextRandom(&seed) % ((1 << 20) / 10 * 9)]->occupied = false;
+        assignFirst(memList, 1);
+    }
+    double listSeconds = elapsedSeconds(&start);
+    freeList(memList);
+    free(blocks);
+    printf("list, 1M blocks, single blocks, AF: %.1f ns per operation\n\n", 1e9 * listSeconds / listOperations);
+
+    printf("%-9s %7s %-6s %11s %11s %8s %16s\n", "blocks", "levels", "method", "run length", "operations", "failed",
+           "ns per operation");
+    for (int b = 0; b < 2; b++) {
+        for (int m = 0; m < 4; m++) {
+            uint64_t maxBlocks = m < 2 ? 1 : 8;
+            uint64_t (*assignMemory)(staticBitmap *bitmap, uint64_t size) =
+                m % 2 == 0 ? assignFirstBitmap : assignNextBitmap;
+            int churnOperations = operations;
+            staticBitmap *bitmap = initializeStaticBitmap(blockCounts[b] * 16, 16);
+            uint32_t failed = 0;
+            seed = 88172645u;
+            fillStaticBitmap(bitmap, &seed);
+            double seconds = churnStaticBitmap(bitmap, assignMemory, maxBlocks, churnOperations, &seed, &failed);
+            printf("%-9s %7d %-6s %11s %11d %8u %16.1f\n", b == 0 ? "1M" : "64M", bitmap->levelCount,
+                   m % 2 == 0 ? "AF" : "AN", maxBlocks == 1 ? "1" : "1-8", churnOperations, failed,
+                   1e9 * seconds / churnOperations);
+            freeStaticBitmap(bitmap);
+        }
+    }
+}
+
+/**
+ * Fragments a dynamic memory into thousands of free blocks: the memory is filled with small blocks, and every other one
+ * is reclaimed.
+ *
+ * @return int the number of blocks that are still allocated, stored in live.
+ */
+int fragmentDynamicMemory(memorySegment *memList, memorySegment **live, uint32_t *seed) {
+    int liveBlocks = 0;
+    memorySegment *block;
+    lastAllocatedBlock = NULL;
+    while ((block = assignNextDyn(memList, 4 + nextRandom(seed) % 8)) != NULL) {
+        live[liveBlocks++] = block;
+    }
+    int kept = 0;
+    for (int i = 0; i < liveBlocks; i++) {
+        if (i % 2 == 0) {
+            reclaimDyn(memList, live[i]);
+        } else {
+            live[kept++] = live[i];
+        }
+    }
+    return kept;
+}
+
+void benchmark_vectorizedBestFit() {
+    printf("\n========================= VECTORIZED BEST FIT =========================\n\n");
+    const int operations = 20000;
+    bestFitKernel kernels[3] = {bestFitScalar, NULL, NULL};
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("sse4.1")) {
+        kernels[1] = bestFitSse41;
+    }
+    if (__builtin_cpu_supports("avx2")) {
+        kernels[2] = bestFitAvx2;
+    }
+#endif
+    memorySegment **live = (memorySegment **)malloc(BenchmarkMemorySize * sizeof(memorySegment *));
+    memorySegment **twinLive = (memorySegment **)malloc(BenchmarkMemorySize * sizeof(memorySegment *));
+    uint16_t largestFree;
+    double listSeconds = 0.0, scalarKernelSeconds = 0.0;
+    volatile int32_t found = 0;
+
+    /* an operation reclaims a block and assigns one, so it includes the upkeep of the index; the search kernel is also
+       timed on its own, on the index as it is before each operation, over a few calls to amortize the clock */
+    printf("%-14s %11s %11s %16s %8s %13s %15s %10s\n", "search", "free blocks", "operations", "ns per operation",
+           "speedup", "ns per search", "search speedup", "different");
+    for (int k = -1; k < 3; k++) {
+        if (k >= 0 && kernels[k] == NULL) {
+            continue;
+        }
+        /* every run replays the trace on a twin memory with the list search too, and compares the chosen blocks */
+        uint32_t seed = 88172645u, twinSeed = 88172645u;
+        memorySegment *memList = initializeDynamicMemory(BenchmarkMemorySize);
+        memorySegment *twinList = initializeDynamicMemory(BenchmarkMemorySize);
+        int liveBlocks = fragmentDynamicMemory(memList, live, &seed);
+        fragmentDynamicMemory(twinList, twinLive, &twinSeed);
+        uint32_t freeBlocks = countFreeSegments(memList, &largestFree);
+        freeIndex index;
+        initializeFreeIndex(&index, memList);
+        bestFit = k >= 0 ? kernels[k] : NULL;
+
+        uint32_t different = 0;
+        double seconds = 0.0, kernelSeconds = 0.0;
+        struct timespec start;
+        for (int op = 0; op < operations && liveBlocks > 0; op++) {
+            int victim = nextRandom(&seed) % liveBlocks;
+            uint16_t requestedMem = 1 + nextRandom(&seed) % 24;
+            memorySegment *block, *twinBlock;
+            if (k >= 0) {
+                clock_gettime(CLOCK_MONOTONIC, &start);
+                for (int r = 0; r < KernelRepetitions; r++) {
+                    found = kernels[k](index.lengths, index.count, requestedMem);
+                }
+                kernelSeconds += elapsedSeconds(&start) / KernelRepetitions;
+            }
+            clock_gettime(CLOCK_MONOTONIC, &start);
+            if (k < 0) {
+                reclaimDyn(memList, live[victim]);
+                block = assignBestDyn(memList, requestedMem);
+            } else {
+                reclaimVecDyn(&index, live[victim]);
+                block = assignBestVecDyn(&index, requestedMem);
+            }
+            seconds += elapsedSeconds(&start);
+
+            reclaimDyn(twinList, twinLive[victim]);
+            twinBlock = assignBestDyn(twinList, requestedMem);
+            if ((block == NULL) != (twinBlock == NULL) ||
+                (block != NULL && block->startAddress != twinBlock->startAddress)) {
+                different++;
+            }
+            if (block != NULL && twinBlock != NULL) {
+                live[victim] = block;
+                twinLive[victim] = twinBlock;
+            } else {
+                live[victim] = live[--liveBlocks];
+                twinLive[victim] = twinLive[liveBlocks];
+            }
+        }
+        if (k < 0) {
+            listSeconds = seconds;
+            printf("%-14s %11u %11d %16.1f %7.1fx %13s %15s %10u\n", "list", freeBlocks, operations,
+                   1e9 * seconds / operations, 1.0, "-", "-", different);
+        } else {
+            if (k == 0) {
+                scalarKernelSeconds = kernelSeconds;
+            }
+            printf("%-14s %11u %11d %16.1f %7.1fx %13.1f %14.2fx %10u\n", bestFitKernelName(kernels[k]), freeBlocks,
+                   operations, 1e9 * seconds / operations, listSeconds / seconds, 1e9 * kernelSeconds / operations,
+                   scalarKernelSeconds / kernelSeconds, different);
+        }
+        freeFreeIndex(&index);
+        freeList(memList);
+        freeList(twinList);
+    }
+    bestFit = NULL;
+    (void)found;
+    free(live);
+    free(twinLive);
+}
+
+/**
+ * Opens a counter of the data TLB misses of the calling thread.
+ *
+ * @return int the counter, or -1 if the hardware counters are not available.
+ */
+int openTlbMissCounter() {
+    struct perf_event_attr attributes;
+    memset(&attributes, 0, sizeof(attributes));
+    attributes.size = sizeof(attributes);
+    attributes.type = PERF_TYPE_HW_CACHE;
+    attributes.config = PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                        (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+    attributes.exclude_kernel = 1;
+    attributes.exclude_hv = 1;
+    return (int)syscall(SYS_perf_event_open, &attributes, 0, -1, -1, 0);
+}
+
+/**
+ * Reads the anonymous memory of the process that is backed by transparent huge pages, in kilobytes.
+ */
+long anonymousHugePages() {
+    FILE *file = fopen("/proc/self/smaps_rollup", "r");
+    if (file == NULL) {
+        return -1;
+    }
+    char line[256];
+    long kilobytes = -1;
+    while (fgets(line, sizeof(line), file) != NULL) {
+        if (sscanf(line, "AnonHugePages: %ld kB", &kilobytes) == 1) {
+            break;
+        }
+    }
+    fclose(file);
+    return kilobytes;
+}
+
+/**
+ * A mixed workload through malloc and free: churn of small objects, with large buffers of 128 KiB to 3 MiB, around the
+ * size of an arena of the malloc interposer, which are read at random. The random reads are then timed on their own,
+ * each one depending on the previous, along with the data TLB misses when the hardware counters are available. It is
+ * meant to run under the interposer, with different settings of MM_LARGE_THRESHOLD and MM_HUGE_PAGES, whose statistics
+ * report the length of the lists of the arenas.
+ */
+void benchmark_largeObjects() {
+    printf("\n========================= LARGE OBJECTS =========================\n\n");
+    const int operations = 100000;
+    const int reads = 4000000;
+    const int maxLargeBuffers = 16;
+    void *small[BenchmarkMaxLiveBlocks] = {NULL};
+    char *large[16] = {NULL};
+    size_t largeSize[16] = {0};
+    uint32_t seed = 2463534242u;
+    uint64_t checksum = 0;
+
+    struct rusage usageAtStart, usage;
+    getrusage(RUSAGE_SELF, &usageAtStart);
+    struct timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    for (int op = 0; op < operations; op++) {
+        if (nextRandom(&seed) % 100 == 0) {
+            int victim = nextRandom(&seed) % maxLargeBuffers;
+            free(large[victim]);
+            largeSize[victim] = (128 + nextRandom(&seed) % 2944) * 1024;
+            large[victim] = (char *)malloc(largeSize[victim]);
+            memset(large[victim], op, largeSize[victim]);
+        } else {
+            int victim = nextRandom(&seed) % BenchmarkMaxLiveBlocks;
+            free(small[victim]);
+            small[victim] = malloc(16 + nextRandom(&seed) % 1009);
+        }
+        /* random reads over the large buffers put pressure on the TLB */
+        for (int i = 0; i < 8; i++) {
+            int buffer = nextRandom(&seed) % maxLargeBuffers;
+            if (large[buffer] != NULL) {
+                checksum += large[buffer][nextRandom(&seed) % largeSize[buffer]];
+            }
+        }
+    }
+
+    double seconds = elapsedSeconds(&start);
+    getrusage(RUSAGE_SELF, &usage);
+
+    int counter = openTlbMissCounter();
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i = 0; i < reads; i++) {
+        int buffer = nextRandom(&seed) % maxLargeBuffers;
+        if (large[buffer] != NULL) {
+            checksum += large[buffer][(nextRandom(&seed) + checksum) % largeSize[buffer]];
+        }
+    }
+    double readSeconds = elapsedSeconds(&start);
+    uint64_t tlbMisses = 0;
+    bool counted = counter >= 0 && read(counter, &tlbMisses, sizeof(tlbMisses)) == sizeof(tlbMisses);
+    long hugePages = anonymousHugePages();
+
+    printf("%d operations in %.2f ms, checksum %llu\n", operations, 1000.0 * seconds, (unsigned long long)checksum);
+    printf("minor page faults: %ld\n", usage.ru_minflt - usageAtStart.ru_minflt);
+    printf("random reads: %.1f ns each\n", 1e9 * readSeconds / reads);
+    if (counted) {
+        printf("data TLB misses: %.3f per random read\n", (double)tlbMisses / reads);
+    } else {
+        printf("data TLB misses: not available\n");
+    }
+    printf("anonymous huge pages: %ld kB\n", hugePages);
+    fflush(stdout);
+    malloc_stats();
+
+    for (int i = 0; i < BenchmarkMaxLiveBlocks; i++) {
+        free(small[i]);
+    }
+    for (int i = 0; i < maxLargeBuffers; i++) {
+        free(large[i]);
+    }
+    if (counter >= 0) {
+        close(counter);
+    }
+}
+
+long residentKilobytes() {
+    FILE *file = fopen("/proc/self/statm", "r");
+    if (file == NULL) {
+        return -1;
+    }
+    long size = 0, resident = -1;
+    if (fscanf(file, "%ld %ld", &size, &resident) != 2) {
+        resident = -1;
+    }
+    fclose(file);
+    return resident * (sysconf(_SC_PAGESIZE) / 1024);
+}
+
+/**
+ * A workload whose heap grows, shrinks and stays idle, and is then partly reused. It is meant to run under the malloc
+ * interposer, with and without its scavenger, whose statistics report the bytes released and re-faulted.
+ */
+void benchmark_scavenger() {
+    printf("\n========================= SCAVENGER =========================\n\n");
+    const int blocks = 3072;
+    const size_t blockSize = 16 * 1024;
+    char **live = (char **)malloc(blocks * sizeof(char *));
+
+    for (int i = 0; i < blocks; i++) {
+        live[i] = (char *)malloc(blockSize);
+        memset(live[i], i, blockSize);
+    }
+    printf("resident after allocating %d blocks of %zu KiB: %ld kB\n", blocks, blockSize / 1024,
+           residentKilobytes());
+
+    /* one block in ten stays live, which keeps every arena in use */
+    for (int i = 0; i < blocks; i++) {
+        if (i % 10 != 0) {
+            free(live[i]);
+            live[i] = NULL;
+        }
+    }
+    printf("resident after freeing 90%%: %ld kB\n", residentKilobytes());
+    struct timespec idle = {1, 0};
+    nanosleep(&idle, NULL);
+    printf("resident after 1 s idle: %ld kB\n", residentKilobytes());
+
+    struct timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i = 0; i < blocks / 2; i++) {
+        if (live[i] == NULL) {
+            live[i] = (char *)malloc(blockSize);
+            memset(live[i], i, blockSize);
+        }
+    }
+    printf("resident after reusing half: %ld kB, reuse took %.2f ms\n", residentKilobytes(),
+           1000.0 * elapsedSeconds(&start));
+    fflush(stdout);
+    malloc_stats();
+
+    for (int i = 0; i < blocks; i++) {
+        free(live[i]);
+    }
+    free(live);
+}
+
+#endif
\ No newline at end of file
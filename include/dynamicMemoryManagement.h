@@ -1,201 +1,557 @@
-#ifndef DYNAMICMEMORYMANAGEMENT
-#define DYNAMICMEMORYMANAGEMENT
-
-#include "memorySegment.h"
-#include "staticMemoryManagement.h"
-
-/**
- * Dynamic memory allocation techniques, for a requested memory size, and memory blocks. Each time a block is allocated, 
- * the remaining unallocated space of the block, is concatenated to the next, if it exists and is free. Otherwise, we
- * insert a new, independent block of the corresponding size, after the allocated space.
- */
-
-/**
- * Accesses the memory in a linear fashion, iterating over one block at a time. It assigns the first memory block, 
- * that fits the requested memory. 
- * 
- * @param memList the memory as a linked list, with each node representing a memory block.
- * @param requestedMem the memory requested by a process.
- * @return memorySegment* the memory block that was allocated by the memory management service.
- */
-memorySegment *assignFirstDyn(memorySegment *memList, uint16_t requestedMem) {
-    memorySegment *currentSegment;
-    currentSegment = memList;
-
-    while(currentSegment != NULL) {
-        if (currentSegment->occupied) {
-            currentSegment = currentSegment->next;
-            continue;
-        } 
-        if (currentSegment->length == requestedMem) {
-            currentSegment->occupied = true;
-            return currentSegment;
-        }
-        if (currentSegment->length > requestedMem) {
-            uint16_t freeMemory = currentSegment->length - requestedMem;
-            currentSegment->occupied = true;
-            currentSegment->length = requestedMem;
-            if (currentSegment->next) {
-                if (currentSegment->next->occupied == false) {
-                    currentSegment->next->startAddress = currentSegment->startAddress + requestedMem;
-                    currentSegment->next->length += freeMemory;
-                    return currentSegment;
-                } 
-            }
-            lengthOfNewBlock = freeMemory;
-            startAddressOfNewBlock = currentSegment->startAddress + requestedMem;
-            insertListItemAfter(currentSegment);
-            return currentSegment;
-        } 
-        currentSegment = currentSegment->next;
-    }
-
-    return (NULL);
-}
-
-/**
- * Accesses the memory in a linear fashion, iterating over one block at a time. It locates the memory block that both 
- * fits the requested memory and is closest to it, in order to minimize memory gaps after memory assignement.
- * 
- * @param memList the memory as a linked list, with each node representing a memory block.
- * @param requestedMem the memory requested by a process.
- * @return memorySegment* the memory block that was allocated by the memory management service.
- */
-memorySegment *assignBestDyn(memorySegment *memList, uint16_t requestedMem) {
-    memorySegment *currentSegment;
-    currentSegment = memList;
-    memorySegment *bestBlock = NULL;
-    uint16_t bestFit = UINT16_MAX;
-    bool exactFit = false;
-
-    while(currentSegment != NULL) {
-        if (currentSegment->occupied) {
-            currentSegment = currentSegment->next;
-            continue;
-        } 
-        if (currentSegment->length == requestedMem) {
-            bestBlock = currentSegment;
-            exactFit = true;
-            break; 
-        }
-        if (currentSegment->length > requestedMem) {
-            uint16_t currentFit = currentSegment->length - requestedMem;
-            if (currentFit <= bestFit) {
-                bestFit = currentFit;
-                bestBlock = currentSegment;
-            }
-        }
-        currentSegment = currentSegment->next; 
-    }
-
-    if (bestBlock == NULL) {
-        return (NULL);
-    }
-    currentSegment = memList;
-
-    while (currentSegment != NULL) {
-        if (currentSegment->occupied) {
-            currentSegment = currentSegment->next;
-            continue;
-        }
-        if (currentSegment->startAddress == bestBlock->startAddress) {
-            uint16_t freeMemory = currentSegment->length - requestedMem;
-            currentSegment->occupied = true;
-            if (exactFit) {
-                return currentSegment;
-            }
-            currentSegment->length = requestedMem;
-            if (currentSegment->next) {
-                if (currentSegment->next->occupied == false) {
-                    currentSegment->next->startAddress = currentSegment->startAddress + requestedMem;
-                    currentSegment->next->length += freeMemory;
-                    return currentSegment;
-                } 
-            }
-            lengthOfNewBlock = freeMemory;
-            startAddressOfNewBlock = currentSegment->startAddress + requestedMem;
-            insertListItemAfter(currentSegment);
-            return currentSegment;
-        }
-        currentSegment = currentSegment->next; 
-    }
-
-    return (NULL);
-}
-
-/**
- * Accesses the memory in a linear fashion, iterating over one block at a time. It has the same functionality as the 
- * Firs Fit, but the searching starts from the block that was allocated during the last memory assignement. It tends to 
- * allocate memory segments at the end of the memory list, leaving gaps which need to be concatenated in order to boost
- * the efficiency of the method.
- * 
- * @param memList the memory as a linked list, with each node representing a memory block.
- * @param requestedMem the memory requested by a process.
- * @return memorySegment* the memory block that was allocated by the memory management service.
- */
-memorySegment *assignNextDyn(memorySegment *memList, uint16_t requestedMem) {
-    memorySegment *currentSegment;
-    if (lastAllocatedBlock == NULL) {
-        currentSegment = memList;
-    } else {
-        currentSegment = lastAllocatedBlock;
-    }
-
-    while(currentSegment != NULL) {
-        if (currentSegment->occupied) {
-            currentSegment = currentSegment->next;
-            continue;
-        } 
-        if (currentSegment->length == requestedMem) {
-            currentSegment->occupied = true;
-            return currentSegment;
-        }
-        if (currentSegment->length > requestedMem) {
-            uint16_t freeMemory = currentSegment->length - requestedMem;
-            currentSegment->occupied = true;
-            currentSegment->length = requestedMem;
-            lastAllocatedBlock = currentSegment;
-            if (currentSegment->next) {
-                if (currentSegment->next->occupied == false) {
-                    currentSegment->next->startAddress = currentSegment->startAddress + requestedMem;
-                    currentSegment->next->length += freeMemory;
-                    return currentSegment;
-                } 
-            }
-            lengthOfNewBlock = freeMemory;
-            startAddressOfNewBlock = currentSegment->startAddress + requestedMem;
-            insertListItemAfter(currentSegment);
-            return currentSegment;
-        }
-        currentSegment = currentSegment->next;
-    }
-
-    return (NULL);
-}
-
-/**
- * Dynamically frees the requested memory block. If the next memory block is free as well, it concatenates the two.
- * 
- * @param memList the memory as a linked list, with each node representing a memory block.
- * @param thisOne the memory block to reclaim.
- */
-void reclaimDyn(memorySegment *memList, memorySegment *thisOne) {
-    memorySegment *currentSegment;
-    currentSegment = memList;
-
-    while (currentSegment != NULL) {
-        if (currentSegment->startAddress == thisOne->startAddress) {
-            currentSegment->occupied = false;
-            if (currentSegment->next) {
-                if (currentSegment->next->occupied == false) {
-                    currentSegment->length += currentSegment->next->length;
-                    currentSegment->next = currentSegment->next->next;
-                }
-            }
-            break;
-        }
-        currentSegment = currentSegment->next;
-    }
-}
-
+#ifndef DYNAMICMEMORYMANAGEMENT
+#define DYNAMICMEMORYMANAGEMENT
+
+#include "memorySegment.h"
+#include "staticMemoryManagement.h"
+
+/**
+ * Dynamic memory allocation techniques, for a requested memory size, and memory blocks. Each time a block is allocated, 
+ * the remaining unallocated space of the block, is concatenated to the next, if it exists and is free. Otherwise, we
+ * insert a new, independent block of the corresponding size, after the allocated space.
+ */
+
+/**
+ * Number of memory blocks visited by the searches of the methods of assignement, used to sample their scan lengths.
+ */
+static _Thread_local uint64_t segmentsVisited = 0;
+
+/**
+ * Length of the free block that the last split divided, before the split, read by the sampling profiler. It is left
+ * unchanged by the requests that fit a free block exactly.
+ */
+static _Thread_local uint16_t splitBlockLength = 0;
+
+/**
+ * The clock that dates the free blocks. It is shared by all threads, and only advances while a scavenger is running.
+ */
+static uint16_t reclaimClock = 0;
+
+/**
+ * Marks a block as freed now, with none of its pages released.
+ */
+void markFreed(memorySegment *segment) {
+    segment->released = false;
+    segment->freedAt = __atomic_load_n(&reclaimClock, __ATOMIC_RELAXED);
+}
+
+/**
+ * Merges the dates of a free block with those of free memory that is concatenated to it. The merged block keeps the
+ * newest of the two dates, so that memory that was just freed, and is likely still in use by the caches, is not
+ * released along with the idle memory next to it. It is released only when both parts were released.
+ *
+ * @param segment the free block that absorbs the memory.
+ * @param freedAt the tick when the absorbed memory became free.
+ * @param released whether the pages of the absorbed memory were released.
+ */
+void mergeFreed(memorySegment *segment, uint16_t freedAt, bool released) {
+    uint16_t now = __atomic_load_n(&reclaimClock, __ATOMIC_RELAXED);
+    if ((uint16_t)(now - freedAt) < (uint16_t)(now - segment->freedAt)) {
+        segment->freedAt = freedAt;
+    }
+    segment->released = segment->released && released;
+}
+
+/**
+ * Accesses the memory in a linear fashion, iterating over one block at a time. It assigns the first memory block, 
+ * that fits the requested memory. 
+ * 
+ * @param memList the memory as a linked list, with each node representing a memory block.
+ * @param requestedMem the memory requested by a process.
+ * @return memorySegment* the memory block that was allocated by the memory management service.
+ */
+memorySegment *assignFirstDyn(memorySegment *memList, uint16_t requestedMem) {
+    memorySegment *currentSegment;
+    currentSegment = memList;
+
+    while(currentSegment != NULL) {
+        segmentsVisited++;
+        if (currentSegment->occupied) {
+            currentSegment = currentSegment->next;
+            continue;
+        } 
+        if (currentSegment->length == requestedMem) {
+            currentSegment->occupied = true;
+            return currentSegment;
+        }
+        if (currentSegment->length > requestedMem) {
+            uint16_t freeMemory = currentSegment->length - requestedMem;
+            splitBlockLength = currentSegment->length;
+            currentSegment->occupied = true;
+            currentSegment->length = requestedMem;
+            if (currentSegment->next) {
+                if (currentSegment->next->occupied == false) {
+                    currentSegment->next->startAddress = currentSegment->startAddress + requestedMem;
+                    currentSegment->next->length += freeMemory;
+                    mergeFreed(currentSegment->next, currentSegment->freedAt, currentSegment->released);
+                    return currentSegment;
+                } 
+            }
+            lengthOfNewBlock = freeMemory;
+            startAddressOfNewBlock = currentSegment->startAddress + requestedMem;
+            insertListItemAfter(currentSegment);
+            return currentSegment;
+        } 
+        currentSegment = currentSegment->next;
+    }
+
+    return (NULL);
+}
+
+/**
+ * Accesses the memory in a linear fashion, iterating over one block at a time. It locates the memory block that both 
+ * fits the requested memory and is closest to it, in order to minimize memory gaps after memory assignement.
+ * 
+ * @param memList the memory as a linked list, with each node representing a memory block.
+ * @param requestedMem the memory requested by a process.
+ * @return memorySegment* the memory block that was allocated by the memory management service.
+ */
+memorySegment *assignBestDyn(memorySegment *memList, uint16_t requestedMem) {
+    memorySegment *currentSegment;
+    currentSegment = memList;
+    memorySegment *bestBlock = NULL;
+    uint16_t bestFit = UINT16_MAX;
+    bool exactFit = false;
+
+    while(currentSegment != NULL) {
+        segmentsVisited++;
+        if (currentSegment->occupied) {
+            currentSegment = currentSegment->next;
+            continue;
+        } 
+        if (currentSegment->length == requestedMem) {
+            bestBlock = currentSegment;
+            exactFit = true;
+            break; 
+        }
+        if (currentSegment->length > requestedMem) {
+            uint16_t currentFit = currentSegment->length - requestedMem;
+            if (currentFit <= bestFit) {
+                bestFit = currentFit;
+                bestBlock = currentSegment;
+            }
+        }
+        currentSegment = currentSegment->next; 
+    }
+
+    if (bestBlock == NULL) {
+        return (NULL);
+    }
+    currentSegment = memList;
+
+    while (currentSegment != NULL) {
+        if (currentSegment->occupied) {
+            currentSegment = currentSegment->next;
+            continue;
+        }
+        if (currentSegment->startAddress == bestBlock->startAddress) {
+            uint16_t freeMemory = currentSegment->length - requestedMem;
+            currentSegment->occupied = true;
+            if (exactFit) {
+                return currentSegment;
+            }
+            splitBlockLength = currentSegment->length;
+            currentSegment->length = requestedMem;
+            if (currentSegment->next) {
+                if (currentSegment->next->occupied == false) {
+                    currentSegment->next->startAddress = currentSegment->startAddress + requestedMem;
+                    currentSegment->next->length += freeMemory;
+                    mergeFreed(currentSegment->next, currentSegment->freedAt, currentSegment->released);
+                    return currentSegment;
+                } 
+            }
+            lengthOfNewBlock = freeMemory;
+            startAddressOfNewBlock = currentSegment->startAddress + requestedMem;
+            insertListItemAfter(currentSegment);
+            return currentSegment;
+        }
+        currentSegment = currentSegment->next; 
+    }
+
+    return (NULL);
+}
+
+/**
+ * Accesses the memory in a linear fashion, iterating over one block at a time. It has the same functionality as the 
+ * Firs Fit, but the searching starts from the block that was allocated during the last memory assignement. It tends to 
+ * allocate memory segments at the end of the memory list, leaving gaps which need to be concatenated in order to boost
+ * the efficiency of the method.
+ * 
+ * @param memList the memory as a linked list, with each node representing a memory block.
+ * @param requestedMem the memory requested by a process.
+ * @return memorySegment* the memory block that was allocated by the memory management service.
+ */
+memorySegment *assignNextDyn(memorySegment *memList, uint16_t requestedMem) {
+    memorySegment *currentSegment;
+    if (lastAllocatedBlock == NULL) {
+        currentSegment = memList;
+    } else {
+        currentSegment = lastAllocatedBlock;
+    }
+
+    while(currentSegment != NULL) {
+        segmentsVisited++;
+        if (currentSegment->occupied) {
+            currentSegment = currentSegment->next;
+            continue;
+        } 
+        if (currentSegment->length == requestedMem) {
+            currentSegment->occupied = true;
+            return currentSegment;
+        }
+        if (currentSegment->length > requestedMem) {
+            uint16_t freeMemory = currentSegment->length - requestedMem;
+            splitBlockLength = currentSegment->length;
+            currentSegment->occupied = true;
+            currentSegment->length = requestedMem;
+            lastAllocatedBlock = currentSegment;
+            if (currentSegment->next) {
+                if (currentSegment->next->occupied == false) {
+                    currentSegment->next->startAddress = currentSegment->startAddress + requestedMem;
+                    currentSegment->next->length += freeMemory;
+                    mergeFreed(currentSegment->next, currentSegment->freedAt, currentSegment->released);
+                    return currentSegment;
+                } 
+            }
+            lengthOfNewBlock = freeMemory;
+            startAddressOfNewBlock = currentSegment->startAddress + requestedMem;
+            insertListItemAfter(currentSegment);
+            return currentSegment;
+        }
+        currentSegment = currentSegment->next;
+    }
+
+    return (NULL);
+}
+
+/**
+ * Splits an unoccupied memory block into an occupied segment of the requested size, followed by the remaining free
+ * space. The free space is concatenated to the next block, if it exists and is free. Otherwise, we insert a new,
+ * independent block of the corresponding size, after the allocated space.
+ *
+ * @param currentSegment the free memory block, at least as long as the requested memory.
+ * @param requestedMem the memory requested by a process.
+ * @return memorySegment* the memory block that was allocated by the memory management service.
+ */
+memorySegment *splitSegmentDyn(memorySegment *currentSegment, uint16_t requestedMem) {
+    currentSegment->occupied = true;
+    if (currentSegment->length == requestedMem) {
+        return currentSegment;
+    }
+    uint16_t freeMemory = currentSegment->length - requestedMem;
+    splitBlockLength = currentSegment->length;
+    currentSegment->length = requestedMem;
+    if (currentSegment->next) {
+        if (currentSegment->next->occupied == false) {
+            currentSegment->next->startAddress = currentSegment->startAddress + requestedMem;
+            currentSegment->next->length += freeMemory;
+            mergeFreed(currentSegment->next, currentSegment->freedAt, currentSegment->released);
+            return currentSegment;
+        }
+    }
+    lengthOfNewBlock = freeMemory;
+    startAddressOfNewBlock = currentSegment->startAddress + requestedMem;
+    insertListItemAfter(currentSegment);
+    return currentSegment;
+}
+
+/**
+ * Aligned dynamic memory allocation techniques. The alignment must be a power of two, and the returned block starts at
+ * a multiple of it. Any free space between the start of the chosen block and the aligned address (the leading padding)
+ * is split into its own free block, so that it is concatenated back with the allocated one on reclaim.
+ */
+
+/**
+ * Computes the distance from the start of a memory block to the first address inside it that satisfies the alignment.
+ *
+ * @param currentSegment the memory block.
+ * @param alignment the requested alignment, a power of two.
+ * @return uint16_t the leading padding of the block.
+ */
+uint16_t alignmentPadding(memorySegment *currentSegment, uint16_t alignment) {
+    return (alignment - (currentSegment->startAddress & (alignment - 1))) & (alignment - 1);
+}
+
+/**
+ * Checks whether a memory block is free and can hold the requested memory, after skipping its leading padding.
+ *
+ * @param currentSegment the memory block.
+ * @param requestedMem the memory requested by a process.
+ * @param alignment the requested alignment, a power of two.
+ * @return bool true if the aligned range fits in the block.
+ */
+bool fitsAligned(memorySegment *currentSegment, uint16_t requestedMem, uint16_t alignment) {
+    if (currentSegment->occupied) {
+        return false;
+    }
+    return (uint32_t)alignmentPadding(currentSegment, alignment) + requestedMem <= currentSegment->length;
+}
+
+/**
+ * Allocates the aligned range inside a free memory block, splitting the leading padding into its own free block.
+ *
+ * @param currentSegment the free memory block, as chosen by one of the fit policies.
+ * @param requestedMem the memory requested by a process.
+ * @param alignment the requested alignment, a power of two.
+ * @return memorySegment* the memory block that was allocated by the memory management service.
+ */
+memorySegment *placeAlignedDyn(memorySegment *currentSegment, uint16_t requestedMem, uint16_t alignment) {
+    uint16_t padding = alignmentPadding(currentSegment, alignment);
+    if (padding > 0) {
+        lengthOfNewBlock = currentSegment->length - padding;
+        startAddressOfNewBlock = currentSegment->startAddress + padding;
+        currentSegment->length = padding;
+        insertListItemAfter(currentSegment);
+        currentSegment = currentSegment->next;
+    }
+    return splitSegmentDyn(currentSegment, requestedMem);
+}
+
+/**
+ * Checks that the alignment is a non-zero power of two.
+ */
+bool isValidAlignment(uint16_t alignment) {
+    return alignment != 0 && (alignment & (alignment - 1)) == 0;
+}
+
+/**
+ * First Fit, for blocks that can hold the requested memory at the requested alignment.
+ *
+ * @param memList the memory as a linked list, with each node representing a memory block.
+ * @param requestedMem the memory requested by a process.
+ * @param alignment the requested alignment, a power of two.
+ * @return memorySegment* the memory block that was allocated by the memory management service.
+ */
+memorySegment *assignFirstAlignedDyn(memorySegment *memList, uint16_t requestedMem, uint16_t alignment) {
+    if (!isValidAlignment(alignment)) {
+        return (NULL);
+    }
+    memorySegment *currentSegment;
+    currentSegment = memList;
+
+    while (currentSegment != NULL) {
+        if (fitsAligned(currentSegment, requestedMem, alignment)) {
+            return placeAlignedDyn(currentSegment, requestedMem, alignment);
+        }
+        currentSegment = currentSegment->next;
+    }
+
+    return (NULL);
+}
+
+/**
+ * Best Fit, for blocks that can hold the requested memory at the requested alignment. The fit of a block is the space
+ * left after both the leading padding and the requested memory are subtracted from it.
+ *
+ * @param memList the memory as a linked list, with each node representing a memory block.
+ * @param requestedMem the memory requested by a process.
+ * @param alignment the requested alignment, a power of two.
+ * @return memorySegment* the memory block that was allocated by the memory management service.
+ */
+memorySegment *assignBestAlignedDyn(memorySegment *memList, uint16_t requestedMem, uint16_t alignment) {
+    if (!isValidAlignment(alignment)) {
+        return (NULL);
+    }
+    memorySegment *currentSegment;
+    currentSegment = memList;
+    memorySegment *bestBlock = NULL;
+    uint16_t bestFit = UINT16_MAX;
+
+    while (currentSegment != NULL) {
+        if (fitsAligned(currentSegment, requestedMem, alignment)) {
+            uint16_t currentFit = currentSegment->length - alignmentPadding(currentSegment, alignment) - requestedMem;
+            if (currentFit == 0) {
+                bestBlock = currentSegment;
+                break;
+            }
+            if (currentFit <= bestFit) {
+                bestFit = currentFit;
+                bestBlock = currentSegment;
+            }
+        }
+        currentSegment = currentSegment->next;
+    }
+
+    if (bestBlock == NULL) {
+        return (NULL);
+    }
+    return placeAlignedDyn(bestBlock, requestedMem, alignment);
+}
+
+/**
+ * Next Fit, for blocks that can hold the requested memory at the requested alignment. The search starts from the block
+ * that was allocated during the last memory assignement.
+ *
+ * @param memList the memory as a linked list, with each node representing a memory block.
+ * @param requestedMem the memory requested by a process.
+ * @param alignment the requested alignment, a power of two.
+ * @return memorySegment* the memory block that was allocated by the memory management service.
+ */
+memorySegment *assignNextAlignedDyn(memorySegment *memList, uint16_t requestedMem, uint16_t alignment) {
+    if (!isValidAlignment(alignment)) {
+        return (NULL);
+    }
+    memorySegment *currentSegment;
+    if (lastAllocatedBlock == NULL) {
+        currentSegment = memList;
+    } else {
+        currentSegment = lastAllocatedBlock;
+    }
+
+    while (currentSegment != NULL) {
+        if (fitsAligned(currentSegment, requestedMem, alignment)) {
+            lastAllocatedBlock = placeAlignedDyn(currentSegment, requestedMem, alignment);
+            return lastAllocatedBlock;
+        }
+        currentSegment = currentSegment->next;
+    }
+
+    return (NULL);
+}
+
+/**
+ * Frees the requested memory block as memory that has been free since the given date, and whose pages may have been
+ * released already, as the scavenger does when it gives back the blocks it held while it released their pages. The
+ * block is concatenated with its free neighbours as in reclaimDyn.
+ *
+ * @param memList the memory as a linked list, with each node representing a memory block.
+ * @param thisOne the memory block to reclaim, either its node or any node with the same start address.
+ * @param freedAt the tick when the memory of the block became free.
+ * @param released whether the pages of the block were released.
+ */
+void reclaimDatedDyn(memorySegment *memList, memorySegment *thisOne, uint16_t freedAt, bool released) {
+    memorySegment *currentSegment;
+    memorySegment *previousSegment = NULL;
+    currentSegment = memList;
+
+    while (currentSegment != NULL) {
+        if (currentSegment->startAddress == thisOne->startAddress) {
+            currentSegment->occupied = false;
+            currentSegment->freedAt = freedAt;
+            currentSegment->released = released;
+            if (currentSegment->next) {
+                if (currentSegment->next->occupied == false) {
+                    memorySegment *mergedSegment = currentSegment->next;
+                    currentSegment->length += mergedSegment->length;
+                    mergeFreed(currentSegment, mergedSegment->freedAt, mergedSegment->released);
+                    currentSegment->next = mergedSegment->next;
+                    if (lastAllocatedBlock == mergedSegment) {
+                        lastAllocatedBlock = currentSegment;
+                    }
+                    releaseSegment(mergedSegment);
+                }
+            }
+            if (previousSegment != NULL && previousSegment->occupied == false) {
+                previousSegment->length += currentSegment->length;
+                mergeFreed(previousSegment, currentSegment->freedAt, currentSegment->released);
+                previousSegment->next = currentSegment->next;
+                if (lastAllocatedBlock == currentSegment) {
+                    lastAllocatedBlock = previousSegment;
+                }
+                releaseSegment(currentSegment);
+                currentSegment = previousSegment;
+            }
+            break;
+        }
+        previousSegment = currentSegment;
+        currentSegment = currentSegment->next;
+    }
+}
+
+/**
+ * Dynamically frees the requested memory block. If the next or the previous memory block is free as well, it
+ * concatenates them, so that the leading padding of aligned blocks is merged back too. The node of each block that is
+ * concatenated into the one before it is released with releaseSegment: the node of the next block, and the node of the
+ * reclaimed block itself when the previous block is free. The caller must not use the reclaimed node afterwards. The
+ * first node of the list is never released.
+ * 
+ * @param memList the memory as a linked list, with each node representing a memory block.
+ * @param thisOne the memory block to reclaim, either its node or any node with the same start address.
+ */
+void reclaimDyn(memorySegment *memList, memorySegment *thisOne) {
+    reclaimDatedDyn(memList, thisOne, __atomic_load_n(&reclaimClock, __ATOMIC_RELAXED), false);
+}
+
+/**
+ * Counters of the resize operations, used to measure how often a block could be resized in place.
+ */
+typedef struct resizeStatistics {
+    uint32_t grownInPlace;
+    uint32_t shrunkInPlace;
+    uint32_t relocated;
+    uint32_t failed;
+} resizeStatistics;
+
+static _Thread_local resizeStatistics resizeStats = {0, 0, 0, 0};
+
+/**
+ * Dynamically resizes an allocated memory block. A block grows in place when the next block is free and long enough,
+ * and shrinks in place by handing its tail to the next block, if it is free, or to a new independent block. Both cases
+ * only touch the block and its neighbour. Otherwise, the requested size is assigned elsewhere with the given method,
+ * and the old block is reclaimed. A size of zero reclaims the block. Like reclaimDyn, it releases the nodes it merges
+ * away: the next block when the block grows over all of it, and the node of the old block when it is reclaimed, which
+ * the caller must then replace with the returned one.
+ *
+ * @param memList the memory as a linked list, with each node representing a memory block.
+ * @param thisOne the allocated memory block to resize.
+ * @param newSize the new size of the memory block.
+ * @param assignMemory the method of assignement, used when the block can not be resized in place.
+ * @return memorySegment* the resized memory block, or NULL if no memory block can hold the new size. In that case the
+ * original block remains allocated.
+ */
+memorySegment *resizeDyn(memorySegment *memList, memorySegment *thisOne, uint16_t newSize,
+                         memorySegment *(*assignMemory)(memorySegment *mem, uint16_t size)) {
+    if (newSize == 0) {
+        reclaimDyn(memList, thisOne);
+        return (NULL);
+    }
+    if (newSize <= thisOne->length) {
+        uint16_t freeMemory = thisOne->length - newSize;
+        if (freeMemory == 0) {
+            return thisOne;
+        }
+        thisOne->length = newSize;
+        resizeStats.shrunkInPlace++;
+        if (thisOne->next) {
+            if (thisOne->next->occupied == false) {
+                thisOne->next->startAddress -= freeMemory;
+                thisOne->next->length += freeMemory;
+                mergeFreed(thisOne->next, __atomic_load_n(&reclaimClock, __ATOMIC_RELAXED), false);
+                return thisOne;
+            }
+        }
+        lengthOfNewBlock = freeMemory;
+        startAddressOfNewBlock = thisOne->startAddress + newSize;
+        insertListItemAfter(thisOne);
+        markFreed(thisOne->next);
+        return thisOne;
+    }
+
+    uint16_t extraMemory = newSize - thisOne->length;
+    memorySegment *nextSegment = thisOne->next;
+    if (nextSegment != NULL && nextSegment->occupied == false && nextSegment->length >= extraMemory) {
+        thisOne->length = newSize;
+        resizeStats.grownInPlace++;
+        if (nextSegment->length == extraMemory) {
+            thisOne->next = nextSegment->next;
+            if (lastAllocatedBlock == nextSegment) {
+                lastAllocatedBlock = thisOne;
+            }
+            releaseSegment(nextSegment);
+        } else {
+            nextSegment->startAddress += extraMemory;
+            nextSegment->length -= extraMemory;
+        }
+        return thisOne;
+    }
+
+    memorySegment *relocatedSegment = (*assignMemory)(memList, newSize);
+    if (relocatedSegment == NULL) {
+        resizeStats.failed++;
+        return (NULL);
+    }
+    reclaimDyn(memList, thisOne);
+    resizeStats.relocated++;
+    return relocatedSegment;
+}
+
 #endif
\ No newline at end of file
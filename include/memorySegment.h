@@ -1,82 +1,129 @@
-#ifndef MEMORYSEGMENT
-#define MEMORYSEGMENT
-
-#include <stdio.h>
-#include <stdlib.h>
-#include <stdint.h>
-#include <stdbool.h>
-#include <limits.h>
-
-/**
- * Each memory segment (block) is represented by a memorySegment structure object.
- */
-typedef struct memorySegment {
-    uint16_t startAddress;
-    uint16_t length;
-    bool occupied;
-    struct memorySegment *next;
-} memorySegment;
-
-/**
- * Functions for the actual handling of the memory segments.
- */
-void printList(memorySegment *memList);
-void insertListItemAfter(memorySegment *current);
-void removeListItemAfter(memorySegment *current);
-
-/**
- * The length and the starting address of the new block to be added, in the dynamic memory handling functions.
- */
-static uint16_t lengthOfNewBlock = 0;
-static uint16_t startAddressOfNewBlock = 0;
-
-void printList(memorySegment *memList) {
-    memorySegment *current;
-    current = memList;
-
-    while (true) {
-        printf("%d %d %s\n", current->startAddress, current->length, current->occupied ? "Occupied!" : "Free");
-        if (current->next == NULL) {
-            break;
-        }
-        current = current->next;
-    }
-}
-
-void insertListItemAfter(memorySegment *current) {
-    memorySegment *newItem;
-    newItem = (memorySegment *)malloc(sizeof(memorySegment));
-    newItem->length = lengthOfNewBlock;
-    newItem->startAddress = startAddressOfNewBlock;
-    newItem->occupied = false;
-
-    if (current != NULL) { printf("ent\n");
-        if (current->next) {
-            newItem->next = current->next;
-            current->next = newItem;
-        } else {
-            current->next = newItem;
-        }
-        current = newItem->next;
-    } else {
-        current = newItem;
-    }
-}
-
-void removeListItemAfter(memorySegment *current) {
-    if (current) {
-        if (current->next->next) {
-            uint16_t offsetToSubtract = current->next->length;
-            current->next = current->next->next;
-            current = current->next;
-            while (current != NULL) {
-                current->startAddress -= offsetToSubtract;
-                current = current->next;
-            }
-        } else {
-            current->next = NULL;
-        }
-    }
-}
-
+#ifndef MEMORYSEGMENT
+#define MEMORYSEGMENT
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <limits.h>
+
+/**
+ * Each memory segment (block) is represented by a memorySegment structure object. For free blocks, freedAt is the tick
+ * of the reclaim clock when the block became free, and released is set once a scavenger has returned its pages.
+ */
+typedef struct memorySegment {
+    uint16_t startAddress;
+    uint16_t length;
+    bool occupied;
+    bool released;
+    uint16_t freedAt;
+    struct memorySegment *next;
+} memorySegment;
+
+/**
+ * The nodes of the memory list are allocated with malloc, unless the including file provides its own allocation, as
+ * the malloc interposer does. The dynamic memory functions release the nodes they merge away, so every node of a
+ * dynamic memory list must come from allocateSegment, usually through createSegment.
+ */
+#ifndef allocateSegment
+#define allocateSegment() ((memorySegment *)malloc(sizeof(memorySegment)))
+#endif
+#ifndef releaseSegment
+#define releaseSegment(segment) free(segment)
+#endif
+
+/**
+ * Functions for the actual handling of the memory segments.
+ */
+memorySegment *createSegment(uint16_t startAddress, uint16_t length, bool occupied);
+void printList(memorySegment *memList);
+void insertListItemAfter(memorySegment *current);
+void removeListItemAfter(memorySegment *current);
+void freeList(memorySegment *memList);
+
+/**
+ * The length and the starting address of the new block to be added, in the dynamic memory handling functions. Like the
+ * rest of the state of the memory handling functions, they are thread-local, so that independent memories can be
+ * handled concurrently by different threads.
+ */
+static _Thread_local uint16_t lengthOfNewBlock = 0;
+static _Thread_local uint16_t startAddressOfNewBlock = 0;
+
+/**
+ * Allocates the node of a memory block, which is not linked to any list yet. A free block is dated at tick zero of the
+ * reclaim clock, with none of its pages released.
+ *
+ * @param startAddress the start address of the memory block.
+ * @param length the length of the memory block.
+ * @param occupied whether the memory block is allocated.
+ * @return memorySegment* the new node.
+ */
+memorySegment *createSegment(uint16_t startAddress, uint16_t length, bool occupied) {
+    memorySegment *segment = allocateSegment();
+    segment->startAddress = startAddress;
+    segment->length = length;
+    segment->occupied = occupied;
+    segment->released = false;
+    segment->freedAt = 0;
+    segment->next = NULL;
+    return segment;
+}
+
+void printList(memorySegment *memList) {
+    memorySegment *current;
+    current = memList;
+
+    while (true) {
+        printf("%d %d %s\n", current->startAddress, current->length, current->occupied ? "Occupied!" : "Free");
+        if (current->next == NULL) {
+            break;
+        }
+        current = current->next;
+    }
+}
+
+void insertListItemAfter(memorySegment *current) {
+    memorySegment *newItem;
+    newItem = createSegment(startAddressOfNewBlock, lengthOfNewBlock, false);
+
+    if (current != NULL) {
+        /* the new block is split off the current one, so it has been free as long, and released alike */
+        newItem->released = current->released;
+        newItem->freedAt = current->freedAt;
+        if (current->next) {
+            newItem->next = current->next;
+            current->next = newItem;
+        } else {
+            current->next = newItem;
+        }
+        current = newItem->next;
+    } else {
+        current = newItem;
+    }
+}
+
+void removeListItemAfter(memorySegment *current) {
+    if (current) {
+        if (current->next->next) {
+            uint16_t offsetToSubtract = current->next->length;
+            current->next = current->next->next;
+            current = current->next;
+            while (current != NULL) {
+                current->startAddress -= offsetToSubtract;
+                current = current->next;
+            }
+        } else {
+            current->next = NULL;
+        }
+    }
+}
+
+void freeList(memorySegment *memList) {
+    while (memList != NULL) {
+        memorySegment *next = memList->next;
+        releaseSegment(memList);
+        memList = next;
+    }
+}
+
 #endif
\ No newline at end of file
@@ -0,0 +1,292 @@
+#ifndef SIMULATOR
+#define SIMULATOR
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "memorySegment.h"
+#include "staticMemoryManagement.h"
+#include "dynamicMemoryManagement.h"
+#include "adaptivePolicy.h"
+#include "tester.h"
+
+/**
+ * Multi-method trace simulation. A trace of A<size> and R<index> requests is loaded once, and replayed concurrently,
+ * by a pool of worker threads, against every configuration of memory type and method of assignement. The trace is
+ * shared read-only; each replay owns its memory, and the state of the memory handling functions is thread-local.
+ */
+
+#define TraceReclaim 0x80000000u
+#define TraceChunk (1 << 16)
+
+/**
+ * The requests of a trace. Each request is encoded in 32 bits: the highest bit marks a reclaim, and the rest hold the
+ * requested memory, or the 1-based index of the block to reclaim.
+ */
+typedef struct trace {
+    uint32_t *requests;
+    size_t length;
+} trace;
+
+typedef struct simulationConfig {
+    char memoryType;
+    uint16_t blockSize;
+    const char *methodName;
+    memorySegment *(*assignMemory)(memorySegment *memList, uint16_t requestedMem);
+} simulationConfig;
+
+typedef struct simulationResult {
+    uint64_t assigned;
+    uint64_t failed;
+    uint64_t reclaimed;
+    uint64_t invalidReclaims;
+    uint32_t finalBlocks;
+    uint32_t freeMemory;
+    uint16_t largestFree;
+    double seconds;
+} simulationResult;
+
+typedef struct simulation {
+    const trace *requests;
+    int memorySize;
+    const simulationConfig *configs;
+    simulationResult *results;
+    int configCount;
+    atomic_int nextConfig;
+} simulation;
+
+/**
+ * The token of the trace file being parsed.
+ */
+typedef struct traceToken {
+    char kind;
+    bool hasDigits;
+    uint64_t value;
+} traceToken;
+
+void endTraceToken(trace *loaded, size_t *capacity, traceToken *token) {
+    if ((token->kind == 'A' || token->kind == 'R') && token->hasDigits) {
+        if (loaded->length == *capacity) {
+            *capacity *= 2;
+            loaded->requests = (uint32_t *)realloc(loaded->requests, *capacity * sizeof(uint32_t));
+        }
+        uint32_t value = token->value > ~TraceReclaim ? ~TraceReclaim : (uint32_t)token->value;
+        loaded->requests[loaded->length++] = token->kind == 'R' ? TraceReclaim | value : value;
+    }
+    token->kind = 0;
+    token->hasDigits = false;
+    token->value = 0;
+}
+
+/**
+ * Loads the requests of a trace file. Tokens that are neither A<size> nor R<index> are skipped, so a line in the format
+ * of parseMessage can be used as a trace too. The file is read in chunks, into a buffer of the caller, so that traces
+ * can be loaded by several threads at once.
+ *
+ * @param path the trace file.
+ * @param loaded the trace to fill.
+ * @return int 0 on success, -1 if the file could not be read.
+ */
+int loadTrace(const char *path, trace *loaded) {
+    FILE *file = fopen(path, "r");
+    if (file == NULL) {
+        return -1;
+    }
+
+    char *buffer = (char *)malloc(TraceChunk);
+    if (buffer == NULL) {
+        fclose(file);
+        return -1;
+    }
+    size_t capacity = 1 << 16;
+    loaded->requests = (uint32_t *)malloc(capacity * sizeof(uint32_t));
+    loaded->length = 0;
+
+    size_t read;
+    bool inToken = false;
+    traceToken token = {0, false, 0};
+
+    while ((read = fread(buffer, 1, TraceChunk, file)) > 0) {
+        for (size_t i = 0; i < read; i++) {
+            char c = buffer[i];
+            if (c == ' ' || c == '\n' || c == '\r' || c == '\t') {
+                if (inToken) {
+                    endTraceToken(loaded, &capacity, &token);
+                    inToken = false;
+                }
+            } else if (!inToken) {
+                inToken = true;
+                token.kind = c;
+            } else if (c >= '0' && c <= '9') {
+                if (token.value <= ~TraceReclaim) {
+                    token.value = token.value * 10 + (c - '0');
+                }
+                token.hasDigits = true;
+            } else {
+                token.kind = 0;
+            }
+        }
+    }
+    if (inToken) {
+        endTraceToken(loaded, &capacity, &token);
+    }
+
+    free(buffer);
+    fclose(file);
+    return 0;
+}
+
+/**
+ * Replays a trace against a fresh memory of the given configuration, without printing the memory after each request.
+ * Reclaims of blocks beyond the end of the memory are counted as invalid and skipped.
+ */
+void replayTrace(const trace *requests, int memorySize, const simulationConfig *config, simulationResult *result) {
+    memset(result, 0, sizeof(*result));
+    lastAllocatedBlock = NULL;
+    initializeAdaptivePolicy(DefaultEpochLength, NULL);
+    memorySegment *memList = config->memoryType == 'S' ? initializeStaticMemory(memorySize, config->blockSize)
+                                                       : initializeDynamicMemory(memorySize);
+    void (*reclaimMemory) (memorySegment *memList, memorySegment* thisOne) =
+        config->memoryType == 'S' ? reclaim : reclaimDyn;
+
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    for (size_t i = 0; i < requests->length; i++) {
+        uint32_t request = requests->requests[i];
+        if ((request & TraceReclaim) == 0) {
+            if (request > UINT16_MAX || (*config->assignMemory)(memList, request) == NULL) {
+                result->failed++;
+            } else {
+                result->assigned++;
+            }
+            continue;
+        }
+        uint32_t indexOfBlockToReclaim = request & ~TraceReclaim;
+        memorySegment *blockToReclaim = memList;
+        while (indexOfBlockToReclaim > 1 && blockToReclaim != NULL) {
+            blockToReclaim = blockToReclaim->next;
+            indexOfBlockToReclaim--;
+        }
+        if (indexOfBlockToReclaim == 0 || blockToReclaim == NULL) {
+            result->invalidReclaims++;
+            continue;
+        }
+        (*reclaimMemory)(memList, blockToReclaim);
+        result->reclaimed++;
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    result->seconds = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+
+    for (memorySegment *currentSegment = memList; currentSegment != NULL; currentSegment = currentSegment->next) {
+        result->finalBlocks++;
+        if (!currentSegment->occupied) {
+            result->freeMemory += currentSegment->length;
+            if (currentSegment->length > result->largestFree) {
+                result->largestFree = currentSegment->length;
+            }
+        }
+    }
+    freeList(memList);
+}
+
+void *simulationWorker(void *argument) {
+    simulation *sweep = (simulation *)argument;
+    while (true) {
+        int config = atomic_fetch_add(&sweep->nextConfig, 1);
+        if (config >= sweep->configCount) {
+            return NULL;
+        }
+        replayTrace(sweep->requests, sweep->memorySize, &sweep->configs[config], &sweep->results[config]);
+    }
+}
+
+/**
+ * Replays a trace file against every static block size and the dynamic memory, with every method of assignement, and
+ * prints one comparison table.
+ *
+ * @param path the trace file.
+ * @param memorySize the size of the simulated memory.
+ * @param threads the number of worker threads, or 0 to use one per online core.
+ */
+void simulate(const char *path, int memorySize, int threads) {
+    trace requests;
+    if (loadTrace(path, &requests) != 0) {
+        printf("Error reading trace %s.", path);
+        exit(1);
+    }
+    if (memorySize <= 0 || memorySize > UINT16_MAX) {
+        memorySize = UINT16_MAX;
+    }
+
+    const uint16_t blockSizes[3] = {64, 256, 1024};
+    const char *methodNames[4] = {"AF", "AB", "AN", "AA"};
+    memorySegment *(*staticMethods[3]) (memorySegment *memList, uint16_t requestedMem) = {
+        assignFirst, assignBest, assignNext
+    };
+    memorySegment *(*dynamicMethods[4]) (memorySegment *memList, uint16_t requestedMem) = {
+        assignFirstDyn, assignBestDyn, assignNextDyn, assignAdaptiveDyn
+    };
+
+    simulationConfig configs[3 * 3 + 4];
+    int configCount = 0;
+    for (int b = 0; b < 3; b++) {
+        for (int m = 0; m < 3; m++) {
+            configs[configCount++] = (simulationConfig){'S', blockSizes[b], methodNames[m], staticMethods[m]};
+        }
+    }
+    for (int m = 0; m < 4; m++) {
+        configs[configCount++] = (simulationConfig){'D', 0, methodNames[m], dynamicMethods[m]};
+    }
+
+    simulationResult results[3 * 3 + 4];
+    simulation sweep = {&requests, memorySize, configs, results, configCount, 0};
+    if (threads <= 0) {
+        threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    }
+    if (threads > configCount) {
+        threads = configCount;
+    }
+    if (threads < 1) {
+        threads = 1;
+    }
+
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    pthread_t workers[3 * 3 + 4];
+    for (int i = 0; i < threads; i++) {
+        pthread_create(&workers[i], NULL, simulationWorker, &sweep);
+    }
+    for (int i = 0; i < threads; i++) {
+        pthread_join(workers[i], NULL);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    double slowest = 0;
+    printf("%zu requests, memory %d, %d threads\n\n", requests.length, memorySize, threads);
+    printf("%-7s %-6s %11s %11s %11s %9s %8s %8s %8s %10s\n", "memory", "method", "assigned", "failed", "reclaimed",
+           "invalid", "blocks", "free", "largest", "time(ms)");
+    for (int i = 0; i < configCount; i++) {
+        char memoryName[8];
+        if (configs[i].memoryType == 'S') {
+            snprintf(memoryName, sizeof(memoryName), "S%d", configs[i].blockSize);
+        } else {
+            snprintf(memoryName, sizeof(memoryName), "D");
+        }
+        printf("%-7s %-6s %11llu %11llu %11llu %9llu %8u %8u %8u %10.2f\n", memoryName, configs[i].methodName,
+               (unsigned long long)results[i].assigned, (unsigned long long)results[i].failed,
+               (unsigned long long)results[i].reclaimed, (unsigned long long)results[i].invalidReclaims,
+               results[i].finalBlocks, results[i].freeMemory, results[i].largestFree, 1000.0 * results[i].seconds);
+        if (results[i].seconds > slowest) {
+            slowest = results[i].seconds;
+        }
+    }
+    printf("\nSweep %.2f ms, slowest single run %.2f ms\n",
+           1000.0 * ((end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9), 1000.0 * slowest);
+    free(requests.requests);
+}
+
+#endif
@@ -0,0 +1,451 @@
+#ifndef STATICBITMAP
+#define STATICBITMAP
+
+#include <string.h>
+#include "memorySegment.h"
+
+/**
+ * Static memory allocation over a hierarchical bitmap, for memories of millions of blocks. Bit i of the lowest level is
+ * set when block i is free, and bit i of every upper level is set when word i of the level below has a set bit. The top
+ * level is a single word, so a free block is found with one ctz per level, whatever the size of the memory. Requests
+ * larger than a block are served by runs of contiguous blocks.
+ *
+ * Runs can not be found through these levels, since a word with a single free block has a set bit too. So for each
+ * class of run lengths, another hierarchy marks the words where a run of at least that length starts: inside the word,
+ * or in the free blocks at its end, followed by the free blocks at the start of the next word. The bitmap also keeps a
+ * hint for each run length up to MaxHintedRun: no run of that many free blocks starts before the hinted block. A search
+ * for a run starts at the hint, skips from one marked word of its class to the next, and moves the hint to the run it
+ * finds. Reclaiming blocks only moves the hints back for the lengths of the run of free blocks that they join.
+ */
+
+#define MaxBitmapLevels 6
+#define MaxHintedRun 64
+#define RunClasses 10
+#define NoFreeBlock UINT64_MAX
+
+/**
+ * The shortest run of each class. A run is searched through the class of the longest length that it reaches.
+ */
+static const uint64_t runClassLengths[RunClasses] = {2, 3, 4, 5, 6, 7, 8, 16, 32, 64};
+
+typedef struct staticBitmap {
+    uint64_t blockCount;
+    uint32_t blockSize;
+    int levelCount;
+    uint64_t wordCount[MaxBitmapLevels];
+    uint64_t *levels[MaxBitmapLevels];
+    int runLevelCount;
+    uint64_t runWordCount[MaxBitmapLevels];
+    uint64_t *runLevels[RunClasses][MaxBitmapLevels];
+    uint16_t *runClasses;
+    uint64_t freeBlocks;
+    uint64_t nextBlock;
+    uint64_t runHints[MaxHintedRun + 1];
+} staticBitmap;
+
+/**
+ * Allocates the levels of a hierarchy over the given number of bits, up to a single top word, with all the bits set or
+ * all of them clear.
+ *
+ * @return int the number of levels.
+ */
+int allocateLevels(uint64_t **levels, uint64_t *wordCount, uint64_t bits, bool set) {
+    int levelCount = 0;
+    do {
+        uint64_t words = (bits + 63) / 64;
+        int level = levelCount++;
+        wordCount[level] = words;
+        levels[level] = (uint64_t *)malloc(words * sizeof(uint64_t));
+        memset(levels[level], set ? 0xff : 0, words * sizeof(uint64_t));
+        if (set && bits % 64 != 0) {
+            levels[level][words - 1] = (1ull << (bits % 64)) - 1;
+        }
+        bits = words;
+    } while (bits > 1);
+    return levelCount;
+}
+
+/**
+ * Sets or clears a bit of the lowest level of a hierarchy, and updates the levels above.
+ */
+void setLevelBit(uint64_t **levels, int levelCount, uint64_t index, bool set) {
+    for (int level = 0; level < levelCount && level < MaxBitmapLevels; level++) {
+        uint64_t *bits = &levels[level][index / 64];
+        bool wasEmpty = *bits == 0;
+        if (set) {
+            *bits |= 1ull << (index % 64);
+        } else {
+            *bits &= ~(1ull << (index % 64));
+        }
+        if ((*bits == 0) == wasEmpty) {
+            break;
+        }
+        index /= 64;
+    }
+}
+
+/**
+ * Marks the classes of the runs that start in the given word of blocks.
+ */
+void updateRunStart(staticBitmap *bitmap, uint64_t word) {
+    uint64_t bits = bitmap->levels[0][word];
+    uint64_t trailingFree = ~bits == 0 ? 64 : __builtin_clzll(~bits);
+    uint64_t nextBits = word + 1 < bitmap->wordCount[0] ? bitmap->levels[0][word + 1] : 0;
+    uint64_t spanningRun = trailingFree > 0 ? trailingFree + (~nextBits == 0 ? 64 : __builtin_ctzll(~nextBits)) : 0;
+
+    /* bit i of starts is set when bits i to i + length - 1 are all set */
+    uint16_t classes = 0;
+    uint64_t starts = bits, length = 1;
+    for (int runClass = 0; runClass < RunClasses; runClass++) {
+        while (length < runClassLengths[runClass]) {
+            uint64_t shift = length < runClassLengths[runClass] - length ? length : runClassLengths[runClass] - length;
+            starts &= starts >> shift;
+            length += shift;
+        }
+        if (starts != 0 || spanningRun >= length) {
+            classes |= 1 << runClass;
+        }
+    }
+
+    uint16_t changed = classes ^ bitmap->runClasses[word];
+    for (int runClass = 0; changed != 0; runClass++, changed >>= 1) {
+        if (changed & 1) {
+            setLevelBit(bitmap->runLevels[runClass], bitmap->runLevelCount, word, (classes >> runClass) & 1);
+        }
+    }
+    bitmap->runClasses[word] = classes;
+}
+
+int runClassOf(uint64_t count) {
+    int runClass = 0;
+    while (runClass + 1 < RunClasses && runClassLengths[runClass + 1] <= count) {
+        runClass++;
+    }
+    return runClass;
+}
+
+/**
+ * Creates a static memory of memorySize / blockSize blocks, all free. The remainder of the memory that does not fill a
+ * whole block is not used.
+ *
+ * @param memorySize the size of the memory.
+ * @param blockSize the size of a memory block.
+ * @return staticBitmap* the bitmap of the memory, or NULL if the memory has no blocks.
+ */
+staticBitmap *initializeStaticBitmap(uint64_t memorySize, uint32_t blockSize) {
+    if (blockSize == 0 || memorySize / blockSize == 0) {
+        return NULL;
+    }
+    staticBitmap *bitmap = (staticBitmap *)calloc(1, sizeof(staticBitmap));
+    bitmap->blockCount = memorySize / blockSize;
+    bitmap->blockSize = blockSize;
+    bitmap->freeBlocks = bitmap->blockCount;
+    bitmap->levelCount = allocateLevels(bitmap->levels, bitmap->wordCount, bitmap->blockCount, true);
+    for (int runClass = 0; runClass < RunClasses; runClass++) {
+        bitmap->runLevelCount = allocateLevels(bitmap->runLevels[runClass], bitmap->runWordCount,
+                                               bitmap->wordCount[0], false);
+    }
+    bitmap->runClasses = (uint16_t *)calloc(bitmap->wordCount[0], sizeof(uint16_t));
+    for (uint64_t word = 0; word < bitmap->wordCount[0]; word++) {
+        updateRunStart(bitmap, word);
+    }
+    return bitmap;
+}
+
+void freeStaticBitmap(staticBitmap *bitmap) {
+    for (int level = 0; level < bitmap->levelCount; level++) {
+        free(bitmap->levels[level]);
+    }
+    for (int runClass = 0; runClass < RunClasses; runClass++) {
+        for (int level = 0; level < bitmap->runLevelCount; level++) {
+            free(bitmap->runLevels[runClass][level]);
+        }
+    }
+    free(bitmap->runClasses);
+    free(bitmap);
+}
+
+/**
+ * Finds the first set bit of a level at or after the given bit. When the rest of a word has no set bit, the search
+ * climbs to the level above to skip the empty words, and then descends again to the first set bit below.
+ */
+uint64_t nextSetBitIn(uint64_t *const *levels, const uint64_t *wordCount, int levelCount, int level, uint64_t from) {
+    int startLevel = level;
+    while (level >= 0 && level < levelCount && level < MaxBitmapLevels) {
+        if (from >= wordCount[level] * 64) {
+            return NoFreeBlock;
+        }
+        uint64_t word = from / 64;
+        uint64_t bits = levels[level][word] & (~0ull << (from % 64));
+        if (bits != 0) {
+            uint64_t bit = word * 64 + __builtin_ctzll(bits);
+            if (level == startLevel) {
+                return bit;
+            }
+            level--;
+            from = bit * 64;
+        } else {
+            level++;
+            from = word + 1;
+        }
+    }
+    return NoFreeBlock;
+}
+
+uint64_t nextSetBit(const staticBitmap *bitmap, int level, uint64_t from) {
+    return nextSetBitIn(bitmap->levels, bitmap->wordCount, bitmap->levelCount, level, from);
+}
+
+/**
+ * Counts the free blocks right before the given block, up to the limit.
+ */
+uint64_t freeBlocksBefore(const staticBitmap *bitmap, uint64_t block, uint64_t limit) {
+    uint64_t count = 0;
+    while (block > 0 && count < limit) {
+        uint64_t last = (block - 1) % 64;
+        uint64_t bits = bitmap->levels[0][(block - 1) / 64] << (63 - last);
+        uint64_t ones = ~bits == 0 ? 64 : __builtin_clzll(~bits);
+        if (ones <= last) {
+            return count + ones;
+        }
+        count += last + 1;
+        block -= last + 1;
+    }
+    return count;
+}
+
+/**
+ * Counts the free blocks from the given block on, up to the limit.
+ */
+uint64_t freeBlocksFrom(const staticBitmap *bitmap, uint64_t block, uint64_t limit) {
+    uint64_t count = 0;
+    while (block < bitmap->blockCount && count < limit) {
+        uint64_t first = block % 64;
+        uint64_t bits = bitmap->levels[0][block / 64] >> first;
+        uint64_t ones = ~bits == 0 ? 64 : __builtin_ctzll(~bits);
+        if (ones < 64 - first) {
+            return count + ones;
+        }
+        count += 64 - first;
+        block += 64 - first;
+    }
+    return count;
+}
+
+/**
+ * Marks the blocks [first, first + count) as occupied, or as free, and updates the levels above.
+ */
+void markBlocks(staticBitmap *bitmap, uint64_t first, uint64_t count, bool occupied) {
+    uint64_t end = first + count;
+    for (uint64_t word = first / 64; word * 64 < end; word++) {
+        uint64_t low = word * 64 > first ? 0 : first % 64;
+        uint64_t high = (word + 1) * 64 <= end ? 64 : end % 64;
+        uint64_t mask = (high == 64 ? ~0ull : (1ull << high) - 1) & (~0ull << low);
+
+        uint64_t index = word;
+        for (int level = 0; level < bitmap->levelCount; level++) {
+            uint64_t *bits = &bitmap->levels[level][index];
+            bool wasEmpty = *bits == 0;
+            if (occupied) {
+                *bits &= ~mask;
+            } else {
+                *bits |= mask;
+            }
+            /* the level above only changes when this word becomes empty, or stops being empty */
+            if ((*bits == 0) == wasEmpty) {
+                break;
+            }
+            mask = 1ull << (index % 64);
+            index /= 64;
+        }
+        /* a run at the start of this word can also extend a run at the end of the previous one */
+        if (word > 0) {
+            updateRunStart(bitmap, word - 1);
+        }
+        updateRunStart(bitmap, word);
+    }
+    if (occupied) {
+        bitmap->freeBlocks -= count;
+        return;
+    }
+    bitmap->freeBlocks += count;
+
+    /* the run that the blocks join starts at most MaxHintedRun blocks before them, or was long enough already */
+    uint64_t before = freeBlocksBefore(bitmap, first, MaxHintedRun);
+    uint64_t runLength = before + count + freeBlocksFrom(bitmap, end, MaxHintedRun);
+    for (uint64_t length = 2; length <= MaxHintedRun && length <= runLength; length++) {
+        if (bitmap->runHints[length] > first - before) {
+            bitmap->runHints[length] = first - before;
+        }
+    }
+}
+
+/**
+ * Finds the first run of count free blocks that starts at or after the given block.
+ */
+uint64_t findFreeRun(const staticBitmap *bitmap, uint64_t from, uint64_t count) {
+    if (count == 1) {
+        uint64_t block = nextSetBit(bitmap, 0, from);
+        return block < bitmap->blockCount ? block : NoFreeBlock;
+    }
+
+    /* every run starts in a marked word of its class, either inside it, or in the free blocks at its end */
+    const uint64_t *leaves = bitmap->levels[0];
+    uint64_t *const *runLevels = bitmap->runLevels[runClassOf(count)];
+    uint64_t word = nextSetBitIn(runLevels, bitmap->runWordCount, bitmap->runLevelCount, 0, from / 64);
+    while (word != NoFreeBlock) {
+        uint64_t bits = leaves[word];
+        if (word == from / 64) {
+            bits &= ~0ull << (from % 64);
+        }
+
+        if (count <= 64) {
+            /* bit i of starts is set when bits i to i + count - 1 are all set */
+            uint64_t starts = bits;
+            for (uint64_t length = 1; length < count && starts != 0;) {
+                uint64_t shift = length < count - length ? length : count - length;
+                starts &= starts >> shift;
+                length += shift;
+            }
+            if (starts != 0) {
+                return word * 64 + __builtin_ctzll(starts);
+            }
+        }
+        if ((bits >> 63) != 0) {
+            uint64_t start = (word + 1) * 64 - (~bits == 0 ? 64 : __builtin_clzll(~bits));
+            if (freeBlocksFrom(bitmap, start, count) >= count) {
+                return start;
+            }
+        }
+        word = nextSetBitIn(runLevels, bitmap->runWordCount, bitmap->runLevelCount, 0, word + 1);
+    }
+    return NoFreeBlock;
+}
+
+/**
+ * Finds the first run of count free blocks that starts at or after the given block, starting the search at the hint of
+ * the run length. A search that covers the memory from its hint on moves the hints of this and longer runs to the run
+ * it finds, or past the end of the memory when there is none.
+ */
+uint64_t findHintedRun(staticBitmap *bitmap, uint64_t from, uint64_t count) {
+    if (count == 1) {
+        return findFreeRun(bitmap, from, 1);
+    }
+    uint64_t hint = bitmap->runHints[count < MaxHintedRun ? count : MaxHintedRun];
+    uint64_t first = findFreeRun(bitmap, from > hint ? from : hint, count);
+    if (from <= hint && count <= MaxHintedRun) {
+        uint64_t lowest = first == NoFreeBlock ? bitmap->blockCount : first;
+        for (uint64_t length = count; length <= MaxHintedRun; length++) {
+            if (bitmap->runHints[length] < lowest) {
+                bitmap->runHints[length] = lowest;
+            }
+        }
+    }
+    return first;
+}
+
+uint64_t blocksFor(const staticBitmap *bitmap, uint64_t requestedMem) {
+    uint64_t count = (requestedMem + bitmap->blockSize - 1) / bitmap->blockSize;
+    return count > 0 ? count : 1;
+}
+
+/**
+ * Assigns the first run of free blocks that fits the requested memory. Since all the blocks have the same size, this is
+ * also the Best Fit for requests of a single block.
+ *
+ * @param bitmap the memory as a hierarchical bitmap.
+ * @param requestedMem the memory requested by a process.
+ * @return uint64_t the first block that was allocated, or NoFreeBlock.
+ */
+uint64_t assignFirstBitmap(staticBitmap *bitmap, uint64_t requestedMem) {
+    uint64_t count = blocksFor(bitmap, requestedMem);
+    if (count > bitmap->freeBlocks) {
+        return NoFreeBlock;
+    }
+    uint64_t first = findHintedRun(bitmap, 0, count);
+    if (first != NoFreeBlock) {
+        markBlocks(bitmap, first, count, true);
+    }
+    return first;
+}
+
+/**
+ * Assigns the first run of free blocks that fits the requested memory, searching from the end of the last allocated
+ * run, and wrapping around to the start of the memory.
+ *
+ * @param bitmap the memory as a hierarchical bitmap.
+ * @param requestedMem the memory requested by a process.
+ * @return uint64_t the first block that was allocated, or NoFreeBlock.
+ */
+uint64_t assignNextBitmap(staticBitmap *bitmap, uint64_t requestedMem) {
+    uint64_t count = blocksFor(bitmap, requestedMem);
+    if (count > bitmap->freeBlocks) {
+        return NoFreeBlock;
+    }
+    uint64_t first = findHintedRun(bitmap, bitmap->nextBlock, count);
+    if (first == NoFreeBlock && bitmap->nextBlock > 0) {
+        first = findHintedRun(bitmap, 0, count);
+    }
+    if (first != NoFreeBlock) {
+        markBlocks(bitmap, first, count, true);
+        bitmap->nextBlock = first + count < bitmap->blockCount ? first + count : 0;
+    }
+    return first;
+}
+
+/**
+ * Checks that the blocks [first, first + count) are inside the memory, and all occupied.
+ */
+bool blocksOccupied(const staticBitmap *bitmap, uint64_t first, uint64_t count) {
+    if (first >= bitmap->blockCount || count > bitmap->blockCount - first) {
+        return false;
+    }
+    uint64_t end = first + count;
+    for (uint64_t word = first / 64; word * 64 < end; word++) {
+        uint64_t low = word * 64 > first ? 0 : first % 64;
+        uint64_t high = (word + 1) * 64 <= end ? 64 : end % 64;
+        uint64_t mask = (high == 64 ? ~0ull : (1ull << high) - 1) & (~0ull << low);
+        if (bitmap->levels[0][word] & mask) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Frees the run of blocks that was assigned for the requested memory. A run that is not entirely occupied, as when it
+ * is freed twice, is rejected, since freeing it would count its free blocks again.
+ *
+ * @param bitmap the memory as a hierarchical bitmap.
+ * @param firstBlock the first block of the run.
+ * @param requestedMem the memory that was requested when the run was assigned.
+ * @return bool false, with the bitmap left as it is, if the run is outside of the memory or has a free block.
+ */
+bool reclaimBitmap(staticBitmap *bitmap, uint64_t firstBlock, uint64_t requestedMem) {
+    uint64_t count = blocksFor(bitmap, requestedMem);
+    if (!blocksOccupied(bitmap, firstBlock, count)) {
+        return false;
+    }
+    markBlocks(bitmap, firstBlock, count, false);
+    return true;
+}
+
+/**
+ * Prints the memory as runs of free and occupied blocks.
+ */
+void printBitmap(const staticBitmap *bitmap) {
+    uint64_t start = 0;
+    while (start < bitmap->blockCount) {
+        bool occupied = (bitmap->levels[0][start / 64] & (1ull << (start % 64))) == 0;
+        uint64_t end = start + 1;
+        while (end < bitmap->blockCount &&
+               ((bitmap->levels[0][end / 64] & (1ull << (end % 64))) == 0) == occupied) {
+            end++;
+        }
+        printf("Blocks %llu-%llu: %s\n", (unsigned long long)start, (unsigned long long)(end - 1),
+               occupied ? "occupied" : "free");
+        start = end;
+    }
+}
+
+#endif
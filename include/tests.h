@@ -1,324 +1,593 @@
-#ifndef TESTS
-#define TESTS
-
-#include "staticMemoryManagement.h"
-#include "dynamicMemoryManagement.h"
-
-/**
- * Functions that perform validity-functionality tests, for the memory-segment handling functions.
- */
-memorySegment *initializeMemory();
-void test_printList();
-void test_insertListItemAfter();
-void test_removeListItemAfter();
-void test_assignFirst();
-void test_assignBest();
-void test_assignNext();
-void test_assignFirstDyn();
-void test_assignBestDyn();
-void test_assignNextDyn();
-
-memorySegment *initializeMemory() {
-    memorySegment *segment1 = (memorySegment *)malloc(sizeof(memorySegment));
-    memorySegment *segment2 = (memorySegment *)malloc(sizeof(memorySegment));
-    memorySegment *segment3 = (memorySegment *)malloc(sizeof(memorySegment));
-    memorySegment *segment4 = (memorySegment *)malloc(sizeof(memorySegment));
-
-    segment1->length = 100;
-    segment1->startAddress = 0;
-    segment1->occupied = true;
-
-    segment2->length = 50;
-    segment2->startAddress = 100;
-    segment2->occupied = false;
-
-    segment3->length = 200;
-    segment3->startAddress = 150;
-    segment3->occupied = false;
-
-    segment4->length = 300;
-    segment4->startAddress = 350;
-    segment4->occupied = false;
-    
-    segment3->next = segment4;
-    segment2->next = segment3;
-    segment1->next = segment2;
-
-    return segment1;
-}
-
-void test_printList() {
-    memorySegment *segment1 = initializeMemory();
-    printList(segment1);
-}
-
-void test_insertListItemAfter() {
-    memorySegment *firstSegment = initializeMemory();
-    printf("Segments before insertion!\n\n");
-    printList(firstSegment);
-
-    memorySegment *thirdSegment = firstSegment->next->next;
-    lengthOfNewBlock = 150;
-    startAddressOfNewBlock = 350;
-    insertListItemAfter(thirdSegment);
-
-    printf("\nSegments after insertion (after 3rd segment!)\n\n");
-    printList(firstSegment);
-}
-
-void test_removeListItemAfter() {
-    memorySegment *firstSegment = initializeMemory();
-    printf("Segments before deletion!\n\n");
-    printList(firstSegment);
-
-    removeListItemAfter(firstSegment->next);
-
-    printf("\nSegments after deletion (of second segment!)\n\n");
-    printList(firstSegment);
-}
-
-void test_assignFirst() {
-    printf("\n========================= ASSIGN FIRST =========================\n\n");
-    memorySegment *segments;
-    segments = initializeMemory();
-    uint16_t requiredMemory = 40;
-
-    printf("Available memory:\n");
-    printList(segments);
-
-    memorySegment *allocatedBlock = assignFirst(segments, requiredMemory);
-    
-    printf("\nMemory requested: %d\n\n", requiredMemory);
-    printList(segments);
-
-    requiredMemory = 170;
-    allocatedBlock = assignFirst(segments, requiredMemory);
-
-    printf("\nMemory requested: %d\n\n", requiredMemory);
-    printList(segments);
-
-    requiredMemory = 500;
-    allocatedBlock = assignFirst(segments, requiredMemory);
-    printf("\nMemory requested: %d\n\n", requiredMemory);
-
-    if (allocatedBlock == NULL) {
-        printf("No available memory found.\n");
-    } else {
-        printf("Memory handling error.\n");
-    }
-
-    memorySegment *blockToReclaim = (memorySegment *)malloc(sizeof(memorySegment));
-    blockToReclaim->startAddress = 100;
-    reclaim(segments, blockToReclaim);
-
-    printf("\nFree block 2.\n\n");
-    printList(segments);
-
-    blockToReclaim->startAddress = 0;
-    reclaim(segments, blockToReclaim);
-
-    printf("\nFree block 1.\n\n");
-    printList(segments);
-}
-
-void test_assignBest() {
-    printf("\n========================= ASSIGN BEST =========================\n\n");
-    memorySegment *segments;
-    segments = initializeMemory();
-
-    uint16_t requiredMemory = 190;
-    printf("Available memory:\n");
-    printList(segments);
-
-    memorySegment *allocatedBlock = assignBest(segments, requiredMemory);
-    
-    printf("\nMemory requested: %d\n\n", requiredMemory);
-    printList(segments);
-
-    requiredMemory = 310;
-    allocatedBlock = assignFirst(segments, requiredMemory);
-    printf("\nMemory requested: %d\n\n", requiredMemory);
-
-    if (allocatedBlock == NULL) {
-        printf("No available memory found.\n");
-    } else {
-        printf("Memory handling error.\n");
-    }
-
-    memorySegment *blockToReclaim = (memorySegment *)malloc(sizeof(memorySegment));
-    blockToReclaim->startAddress = 150;
-    reclaim(segments, blockToReclaim);
-
-    printf("\nFree block 3.\n\n");
-    printList(segments);
-}
-
-void test_assignNext() {
-    printf("\n========================= ASSIGN NEXT =========================\n\n");
-    memorySegment *segments;
-    segments = initializeMemory();
-
-    uint16_t requiredMemory = 60;
-    printf("Available memory:\n");
-    printList(segments);
-
-    memorySegment *allocatedBlock = assignNext(segments, requiredMemory);
-
-    printf("\nMemory requested: %d\n\n", requiredMemory);
-    printList(segments);
-
-    requiredMemory = 20;
-    allocatedBlock = assignNext(segments, requiredMemory);
-
-    printf("\nMemory requested: %d\n\n", requiredMemory);
-    printList(segments);
-
-    requiredMemory = 500;
-    allocatedBlock = assignNext(segments, requiredMemory);
-    printf("\nMemory requested: %d\n\n", requiredMemory);
-
-    if (allocatedBlock == NULL) {
-        printf("No available memory found.\n");
-    } else {
-        printf("Memory handling error.\n");
-    }
-
-    memorySegment *blockToReclaim = (memorySegment *)malloc(sizeof(memorySegment));
-    blockToReclaim->startAddress = 350;
-    reclaim(segments, blockToReclaim);
-
-    printf("\nFree block 4.\n\n");
-    printList(segments);
-}
-
-void test_assignFirstDyn() {
-    printf("\n========================= ASSIGN FIRST =========================\n\n");
-    memorySegment *segments;
-    segments = initializeMemory();
-
-    printf("Current memory state:\n");
-    printList(segments);
-
-    uint16_t requiredMemory = 150;
-    memorySegment *allocatedBlock = assignFirstDyn(segments, requiredMemory);
-    printf("\nMemory requested: %d\n\n", requiredMemory);
-    printList(segments);
-
-    requiredMemory = 40;
-    allocatedBlock = assignFirstDyn(segments, requiredMemory);
-    printf("\nMemory requested: %d\n\n", requiredMemory);
-    printList(segments);
-
-    requiredMemory = 10;
-    allocatedBlock = assignFirstDyn(segments, requiredMemory);
-    printf("\nMemory requested: %d\n\n", requiredMemory);
-    printList(segments);
-
-    requiredMemory = 320;
-    allocatedBlock = assignFirstDyn(segments, requiredMemory);
-    printf("\nMemory requested: %d\n\n", requiredMemory);
-    printList(segments);
-
-    memorySegment *blockToReclaim = (memorySegment *)malloc(sizeof(memorySegment));
-    blockToReclaim->startAddress = 100;
-    reclaimDyn(segments, blockToReclaim);
-    printf("\nFree block 2.\n\n");
-    printList(segments);
-
-    blockToReclaim->startAddress = 300;
-    reclaimDyn(segments, blockToReclaim);
-    printf("\nFree block 5.\n\n");
-    printList(segments);
-
-    blockToReclaim->startAddress = 0;
-    reclaimDyn(segments, blockToReclaim);
-    printf("\nFree block 1.\n\n");
-    printList(segments);
-}
-
-void test_assignBestDyn() {
-    printf("\n========================= ASSIGN BEST =========================\n\n");
-    memorySegment *segments;
-    segments = initializeMemory();
-
-    printf("Current memory state:\n");
-    printList(segments);
-
-    uint16_t requiredMemory = 280;  
-    memorySegment *allocatedBlock = assignBestDyn(segments, requiredMemory);
-    printf("\nMemory requested: %d\n\n", requiredMemory);
-    printList(segments);
-
-    requiredMemory = 10;
-    allocatedBlock = assignBestDyn(segments, requiredMemory);
-    printf("\nMemory requested: %d\n\n", requiredMemory);
-    printList(segments);
-
-    requiredMemory = 30;
-    allocatedBlock = assignBestDyn(segments, requiredMemory);
-    printf("\nMemory requested: %d\n\n", requiredMemory);
-    printList(segments);
-
-    requiredMemory = 10;
-    allocatedBlock = assignBestDyn(segments, requiredMemory);
-    printf("\nMemory requested: %d\n\n", requiredMemory);
-    printList(segments);
-
-    memorySegment *blockToReclaim = (memorySegment *)malloc(sizeof(memorySegment));
-    blockToReclaim->startAddress = 100;
-    reclaimDyn(segments, blockToReclaim);
-    printf("\nFree block 1.\n\n");
-    printList(segments);
-
-    blockToReclaim->startAddress = 640;
-    reclaimDyn(segments, blockToReclaim);
-    printf("\nFree block 5.\n\n");
-    printList(segments);
-
-    blockToReclaim->startAddress = 630;
-    reclaimDyn(segments, blockToReclaim);
-    printf("\nFree block 4.\n\n");
-    printList(segments);
-}
-
-void test_assignNextDyn() {
-    printf("\n========================= ASSIGN NEXT =========================\n\n");
-    memorySegment *segments;
-    segments = initializeMemory();
-
-    printf("Current memory state:\n");
-    printList(segments);
-
-    uint16_t requiredMemory = 170;
-    memorySegment *allocatedBlock = assignNextDyn(segments, requiredMemory);
-    printf("\nMemory requested: %d\n\n", requiredMemory);
-    printList(segments);
-
-    requiredMemory = 40;
-    allocatedBlock = assignNextDyn(segments, requiredMemory);
-    printf("\nMemory requested: %d\n\n", requiredMemory);
-    printList(segments);
-
-    requiredMemory = 230;
-    allocatedBlock = assignNextDyn(segments, requiredMemory);
-    printf("\nMemory requested: %d\n\n", requiredMemory);
-    printList(segments);
-
-    memorySegment *blockToReclaim = (memorySegment *)malloc(sizeof(memorySegment));
-    blockToReclaim->startAddress = 360;
-    reclaimDyn(segments, blockToReclaim);
-    printf("\nFree block 5.\n\n");
-    printList(segments);
-
-    blockToReclaim->startAddress = 320;
-    reclaimDyn(segments, blockToReclaim);
-    printf("\nFree block 4.\n\n");
-    printList(segments);
-
-    blockToReclaim->startAddress = 150;
-    reclaimDyn(segments, blockToReclaim);
-    printf("\nFree block 3.\n\n");
-    printList(segments);
-}
-
+#ifndef TESTS
+#define TESTS
+
+#include "staticMemoryManagement.h"
+#include "staticBitmap.h"
+#include "dynamicMemoryManagement.h"
+#include "adaptivePolicy.h"
+#include "allocationProfiler.h"
+#include "traceRecorder.h"
+#include "vectorizedBestFit.h"
+
+/**
+ * Functions that perform validity-functionality tests, for the memory-segment handling functions.
+ */
+memorySegment *initializeMemory();
+void test_printList();
+void test_insertListItemAfter();
+void test_removeListItemAfter();
+void test_assignFirst();
+void test_assignBest();
+void test_assignNext();
+void test_assignBitmap();
+void test_assignFirstDyn();
+void test_assignBestDyn();
+void test_assignBestVecDyn();
+void test_assignNextDyn();
+void test_assignAlignedDyn();
+void test_resizeDyn();
+void test_assignAdaptiveDyn();
+void test_allocationProfiler();
+void test_traceRecorder();
+
+memorySegment *initializeMemory() {
+    memorySegment *segment1 = createSegment(0, 100, true);
+    memorySegment *segment2 = createSegment(100, 50, false);
+    memorySegment *segment3 = createSegment(150, 200, false);
+    memorySegment *segment4 = createSegment(350, 300, false);
+
+    segment3->next = segment4;
+    segment2->next = segment3;
+    segment1->next = segment2;
+
+    return segment1;
+}
+
+void test_printList() {
+    memorySegment *segment1 = initializeMemory();
+    printList(segment1);
+}
+
+void test_insertListItemAfter() {
+    memorySegment *firstSegment = initializeMemory();
+    printf("Segments before insertion!\n\n");
+    printList(firstSegment);
+
+    memorySegment *thirdSegment = firstSegment->next->next;
+    lengthOfNewBlock = 150;
+    startAddressOfNewBlock = 350;
+    insertListItemAfter(thirdSegment);
+
+    printf("\nSegments after insertion (after 3rd segment!)\n\n");
+    printList(firstSegment);
+}
+
+void test_removeListItemAfter() {
+    memorySegment *firstSegment = initializeMemory();
+    printf("Segments before deletion!\n\n");
+    printList(firstSegment);
+
+    removeListItemAfter(firstSegment->next);
+
+    printf("\nSegments after deletion (of second segment!)\n\n");
+    printList(firstSegment);
+}
+
+void test_assignFirst() {
+    printf("\n========================= ASSIGN FIRST =========================\n\n");
+    memorySegment *segments;
+    segments = initializeMemory();
+    uint16_t requiredMemory = 40;
+
+    printf("Available memory:\n");
+    printList(segments);
+
+    memorySegment *allocatedBlock = assignFirst(segments, requiredMemory);
+    
+    printf("\nMemory requested: %d\n\n", requiredMemory);
+    printList(segments);
+
+    requiredMemory = 170;
+    allocatedBlock = assignFirst(segments, requiredMemory);
+
+    printf("\nMemory requested: %d\n\n", requiredMemory);
+    printList(segments);
+
+    requiredMemory = 500;
+    allocatedBlock = assignFirst(segments, requiredMemory);
+    printf("\nMemory requested: %d\n\n", requiredMemory);
+
+    if (allocatedBlock == NULL) {
+        printf("No available memory found.\n");
+    } else {
+        printf("Memory handling error.\n");
+    }
+
+    memorySegment *blockToReclaim = (memorySegment *)malloc(sizeof(memorySegment));
+    blockToReclaim->startAddress = 100;
+    reclaim(segments, blockToReclaim);
+
+    printf("\nFree block 2.\n\n");
+    printList(segments);
+
+    blockToReclaim->startAddress = 0;
+    reclaim(segments, blockToReclaim);
+
+    printf("\nFree block 1.\n\n");
+    printList(segments);
+}
+
+void test_assignBest() {
+    printf("\n========================= ASSIGN BEST =========================\n\n");
+    memorySegment *segments;
+    segments = initializeMemory();
+
+    uint16_t requiredMemory = 190;
+    printf("Available memory:\n");
+    printList(segments);
+
+    memorySegment *allocatedBlock = assignBest(segments, requiredMemory);
+    
+    printf("\nMemory requested: %d\n\n", requiredMemory);
+    printList(segments);
+
+    requiredMemory = 310;
+    allocatedBlock = assignFirst(segments, requiredMemory);
+    printf("\nMemory requested: %d\n\n", requiredMemory);
+
+    if (allocatedBlock == NULL) {
+        printf("No available memory found.\n");
+    } else {
+        printf("Memory handling error.\n");
+    }
+
+    memorySegment *blockToReclaim = (memorySegment *)malloc(sizeof(memorySegment));
+    blockToReclaim->startAddress = 150;
+    reclaim(segments, blockToReclaim);
+
+    printf("\nFree block 3.\n\n");
+    printList(segments);
+}
+
+void test_assignNext() {
+    printf("\n========================= ASSIGN NEXT =========================\n\n");
+    memorySegment *segments;
+    segments = initializeMemory();
+
+    uint16_t requiredMemory = 60;
+    printf("Available memory:\n");
+    printList(segments);
+
+    memorySegment *allocatedBlock = assignNext(segments, requiredMemory);
+
+    printf("\nMemory requested: %d\n\n", requiredMemory);
+    printList(segments);
+
+    requiredMemory = 20;
+    allocatedBlock = assignNext(segments, requiredMemory);
+
+    printf("\nMemory requested: %d\n\n", requiredMemory);
+    printList(segments);
+
+    requiredMemory = 500;
+    allocatedBlock = assignNext(segments, requiredMemory);
+    printf("\nMemory requested: %d\n\n", requiredMemory);
+
+    if (allocatedBlock == NULL) {
+        printf("No available memory found.\n");
+    } else {
+        printf("Memory handling error.\n");
+    }
+
+    memorySegment *blockToReclaim = (memorySegment *)malloc(sizeof(memorySegment));
+    blockToReclaim->startAddress = 350;
+    reclaim(segments, blockToReclaim);
+
+    printf("\nFree block 4.\n\n");
+    printList(segments);
+}
+
+void test_assignBitmap() {
+    printf("\n========================= ASSIGN BITMAP =========================\n\n");
+    staticBitmap *bitmap = initializeStaticBitmap(3200, 16);
+    printf("Memory of %llu blocks of %u, %d levels\n", (unsigned long long)bitmap->blockCount, bitmap->blockSize,
+           bitmap->levelCount);
+
+    uint64_t requiredMemory = 10;
+    uint64_t firstRun = assignFirstBitmap(bitmap, requiredMemory);
+    printf("\nMemory requested: %llu, assigned block %llu\n\n", (unsigned long long)requiredMemory,
+           (unsigned long long)firstRun);
+    printBitmap(bitmap);
+
+    requiredMemory = 1500;
+    uint64_t secondRun = assignFirstBitmap(bitmap, requiredMemory);
+    printf("\nMemory requested: %llu, assigned blocks %llu-%llu\n\n", (unsigned long long)requiredMemory,
+           (unsigned long long)secondRun, (unsigned long long)(secondRun + blocksFor(bitmap, requiredMemory) - 1));
+    printBitmap(bitmap);
+
+    requiredMemory = 2500;
+    if (assignFirstBitmap(bitmap, requiredMemory) == NoFreeBlock) {
+        printf("\nMemory requested: %llu, no available memory found.\n", (unsigned long long)requiredMemory);
+    } else {
+        printf("\nMemory handling error.\n");
+    }
+
+    reclaimBitmap(bitmap, firstRun, 10);
+    printf("\nFree block %llu.\n\n", (unsigned long long)firstRun);
+    printBitmap(bitmap);
+    uint64_t freeBlocks = bitmap->freeBlocks;
+    bool rejected = !reclaimBitmap(bitmap, firstRun, 10) && bitmap->freeBlocks == freeBlocks;
+    printf("\nFree block %llu again: %s\n", (unsigned long long)firstRun, rejected ? "rejected" : "accepted");
+
+    requiredMemory = 32;
+    uint64_t nextRun = assignNextBitmap(bitmap, requiredMemory);
+    printf("\nMemory requested with Next Fit: %llu, assigned blocks %llu-%llu\n\n",
+           (unsigned long long)requiredMemory, (unsigned long long)nextRun,
+           (unsigned long long)(nextRun + blocksFor(bitmap, requiredMemory) - 1));
+    printBitmap(bitmap);
+    freeStaticBitmap(bitmap);
+}
+
+void test_assignFirstDyn() {
+    printf("\n========================= ASSIGN FIRST =========================\n\n");
+    memorySegment *segments;
+    segments = initializeMemory();
+
+    printf("Current memory state:\n");
+    printList(segments);
+
+    uint16_t requiredMemory = 150;
+    memorySegment *allocatedBlock = assignFirstDyn(segments, requiredMemory);
+    printf("\nMemory requested: %d\n\n", requiredMemory);
+    printList(segments);
+
+    requiredMemory = 40;
+    allocatedBlock = assignFirstDyn(segments, requiredMemory);
+    printf("\nMemory requested: %d\n\n", requiredMemory);
+    printList(segments);
+
+    requiredMemory = 10;
+    allocatedBlock = assignFirstDyn(segments, requiredMemory);
+    printf("\nMemory requested: %d\n\n", requiredMemory);
+    printList(segments);
+
+    requiredMemory = 320;
+    allocatedBlock = assignFirstDyn(segments, requiredMemory);
+    printf("\nMemory requested: %d\n\n", requiredMemory);
+    printList(segments);
+
+    memorySegment *blockToReclaim = (memorySegment *)malloc(sizeof(memorySegment));
+    blockToReclaim->startAddress = 100;
+    reclaimDyn(segments, blockToReclaim);
+    printf("\nFree block 2.\n\n");
+    printList(segments);
+
+    blockToReclaim->startAddress = 300;
+    reclaimDyn(segments, blockToReclaim);
+    printf("\nFree block 5.\n\n");
+    printList(segments);
+
+    blockToReclaim->startAddress = 0;
+    reclaimDyn(segments, blockToReclaim);
+    printf("\nFree block 1.\n\n");
+    printList(segments);
+}
+
+void test_assignBestDyn() {
+    printf("\n========================= ASSIGN BEST =========================\n\n");
+    memorySegment *segments;
+    segments = initializeMemory();
+
+    printf("Current memory state:\n");
+    printList(segments);
+
+    uint16_t requiredMemory = 280;  
+    memorySegment *allocatedBlock = assignBestDyn(segments, requiredMemory);
+    printf("\nMemory requested: %d\n\n", requiredMemory);
+    printList(segments);
+
+    requiredMemory = 10;
+    allocatedBlock = assignBestDyn(segments, requiredMemory);
+    printf("\nMemory requested: %d\n\n", requiredMemory);
+    printList(segments);
+
+    requiredMemory = 30;
+    allocatedBlock = assignBestDyn(segments, requiredMemory);
+    printf("\nMemory requested: %d\n\n", requiredMemory);
+    printList(segments);
+
+    requiredMemory = 10;
+    allocatedBlock = assignBestDyn(segments, requiredMemory);
+    printf("\nMemory requested: %d\n\n", requiredMemory);
+    printList(segments);
+
+    memorySegment *blockToReclaim = (memorySegment *)malloc(sizeof(memorySegment));
+    blockToReclaim->startAddress = 100;
+    reclaimDyn(segments, blockToReclaim);
+    printf("\nFree block 1.\n\n");
+    printList(segments);
+
+    blockToReclaim->startAddress = 640;
+    reclaimDyn(segments, blockToReclaim);
+    printf("\nFree block 5.\n\n");
+    printList(segments);
+
+    blockToReclaim->startAddress = 630;
+    reclaimDyn(segments, blockToReclaim);
+    printf("\nFree block 4.\n\n");
+    printList(segments);
+}
+
+void test_assignBestVecDyn() {
+    printf("\n========================= ASSIGN BEST (VECTORIZED) =========================\n\n");
+    memorySegment *segments;
+    segments = initializeMemory();
+    freeIndex index;
+    initializeFreeIndex(&index, segments);
+
+    printf("Current memory state:\n");
+    printList(segments);
+
+    uint16_t requests[4] = {280, 10, 30, 10};
+    memorySegment *allocatedBlocks[4];
+    for (int i = 0; i < 4; i++) {
+        allocatedBlocks[i] = assignBestVecDyn(&index, requests[i]);
+        printf("\nMemory requested: %d\n\n", requests[i]);
+        printList(segments);
+    }
+
+    reclaimVecDyn(&index, allocatedBlocks[3]);
+    printf("\nFree block 4.\n\n");
+    printList(segments);
+
+    reclaimVecDyn(&index, allocatedBlocks[2]);
+    printf("\nFree block 3.\n\n");
+    printList(segments);
+
+    printf("\nFree block lengths:");
+    for (uint32_t i = 0; i < index.count; i++) {
+        printf(" %d", index.lengths[i]);
+    }
+    printf("\n");
+    freeFreeIndex(&index);
+}
+
+void test_assignNextDyn() {
+    printf("\n========================= ASSIGN NEXT =========================\n\n");
+    memorySegment *segments;
+    segments = initializeMemory();
+
+    printf("Current memory state:\n");
+    printList(segments);
+
+    uint16_t requiredMemory = 170;
+    memorySegment *allocatedBlock = assignNextDyn(segments, requiredMemory);
+    printf("\nMemory requested: %d\n\n", requiredMemory);
+    printList(segments);
+
+    requiredMemory = 40;
+    allocatedBlock = assignNextDyn(segments, requiredMemory);
+    printf("\nMemory requested: %d\n\n", requiredMemory);
+    printList(segments);
+
+    requiredMemory = 230;
+    allocatedBlock = assignNextDyn(segments, requiredMemory);
+    printf("\nMemory requested: %d\n\n", requiredMemory);
+    printList(segments);
+
+    memorySegment *blockToReclaim = (memorySegment *)malloc(sizeof(memorySegment));
+    blockToReclaim->startAddress = 360;
+    reclaimDyn(segments, blockToReclaim);
+    printf("\nFree block 5.\n\n");
+    printList(segments);
+
+    blockToReclaim->startAddress = 320;
+    reclaimDyn(segments, blockToReclaim);
+    printf("\nFree block 4.\n\n");
+    printList(segments);
+
+    blockToReclaim->startAddress = 150;
+    reclaimDyn(segments, blockToReclaim);
+    printf("\nFree block 3.\n\n");
+    printList(segments);
+}
+
+void test_assignAlignedDyn() {
+    printf("\n========================= ASSIGN ALIGNED =========================\n\n");
+    memorySegment *segments;
+    segments = initializeMemory();
+    lastAllocatedBlock = NULL;
+
+    printf("Current memory state:\n");
+    printList(segments);
+
+    uint16_t requiredMemory = 30;
+    uint16_t alignment = 64;
+    memorySegment *allocatedBlock = assignFirstAlignedDyn(segments, requiredMemory, alignment);
+    printf("\nMemory requested: %d, aligned to %d (first fit)\n\n", requiredMemory, alignment);
+    printList(segments);
+
+    requiredMemory = 100;
+    alignment = 128;
+    allocatedBlock = assignBestAlignedDyn(segments, requiredMemory, alignment);
+    printf("\nMemory requested: %d, aligned to %d (best fit)\n\n", requiredMemory, alignment);
+    printList(segments);
+
+    requiredMemory = 40;
+    alignment = 32;
+    allocatedBlock = assignNextAlignedDyn(segments, requiredMemory, alignment);
+    printf("\nMemory requested: %d, aligned to %d (next fit)\n\n", requiredMemory, alignment);
+    printList(segments);
+
+    requiredMemory = 10;
+    alignment = 3;
+    allocatedBlock = assignFirstAlignedDyn(segments, requiredMemory, alignment);
+    printf("\nMemory requested: %d, aligned to %d\n\n", requiredMemory, alignment);
+
+    if (allocatedBlock == NULL) {
+        printf("Invalid alignment rejected.\n");
+    } else {
+        printf("Memory handling error.\n");
+    }
+
+    memorySegment *blockToReclaim = (memorySegment *)malloc(sizeof(memorySegment));
+    blockToReclaim->startAddress = 192;
+    reclaimDyn(segments, blockToReclaim);
+    printf("\nFree block at 192, padding is concatenated back.\n\n");
+    printList(segments);
+
+    blockToReclaim->startAddress = 256;
+    reclaimDyn(segments, blockToReclaim);
+    printf("\nFree block at 256.\n\n");
+    printList(segments);
+}
+
+void test_resizeDyn() {
+    printf("\n========================= RESIZE =========================\n\n");
+    memorySegment *segments;
+    segments = initializeMemory();
+
+    printf("Current memory state:\n");
+    printList(segments);
+
+    uint16_t requiredMemory = 150;
+    memorySegment *allocatedBlock = assignFirstDyn(segments, requiredMemory);
+    printf("\nMemory requested: %d\n\n", requiredMemory);
+    printList(segments);
+
+    requiredMemory = 200;
+    allocatedBlock = resizeDyn(segments, allocatedBlock, requiredMemory, assignFirstDyn);
+    printf("\nBlock 3 resized to %d (grows in place)\n\n", requiredMemory);
+    printList(segments);
+
+    requiredMemory = 120;
+    allocatedBlock = resizeDyn(segments, allocatedBlock, requiredMemory, assignFirstDyn);
+    printf("\nBlock 3 resized to %d (shrinks in place)\n\n", requiredMemory);
+    printList(segments);
+
+    requiredMemory = 140;
+    allocatedBlock = resizeDyn(segments, segments, requiredMemory, assignFirstDyn);
+    printf("\nBlock 1 resized to %d (grows in place)\n\n", requiredMemory);
+    printList(segments);
+
+    requiredMemory = 160;
+    allocatedBlock = resizeDyn(segments, segments, requiredMemory, assignFirstDyn);
+    printf("\nBlock 1 resized to %d (relocated)\n\n", requiredMemory);
+    printList(segments);
+
+    printf("\nGrown in place: %u, shrunk in place: %u, relocated: %u, failed: %u\n", resizeStats.grownInPlace,
+           resizeStats.shrunkInPlace, resizeStats.relocated, resizeStats.failed);
+}
+
+void test_assignAdaptiveDyn() {
+    printf("\n========================= ASSIGN ADAPTIVE =========================\n\n");
+    memorySegment *segments;
+    segments = initializeMemory();
+    initializeAdaptivePolicy(4, stdout);
+
+    printf("Current memory state:\n");
+    printList(segments);
+
+    uint16_t requests[8] = {20, 20, 20, 20, 120, 30, 250, 40};
+    for (int i = 0; i < 8; i++) {
+        memorySegment *allocatedBlock = assignAdaptiveDyn(segments, requests[i]);
+        printf("\nMemory requested: %d (%s)\n\n", requests[i], allocatedBlock ? "assigned" : "no available memory");
+        printList(segments);
+        if (i == 3) {
+            memorySegment *blockToReclaim = (memorySegment *)malloc(sizeof(memorySegment));
+            blockToReclaim->startAddress = 100;
+            reclaimDyn(segments, blockToReclaim);
+            blockToReclaim->startAddress = 140;
+            reclaimDyn(segments, blockToReclaim);
+            printf("\nFree blocks at 100 and 140.\n\n");
+            printList(segments);
+        }
+    }
+
+    printf("\nMethod in use: %s, switches: %u\n", policyName(adaptiveState.policy), adaptiveState.switches);
+}
+
+void test_allocationProfiler() {
+    printf("\n========================= ALLOCATION PROFILER =========================\n\n");
+    memorySegment *segments;
+    segments = initializeMemory();
+    initializeProfiler(1);
+
+    uint16_t requests[4] = {30, 10, 200, 20};
+    uint16_t callers[4] = {1, 2, 1, 3};
+    memorySegment *allocatedBlocks[4];
+    for (int i = 0; i < 4; i++) {
+        allocatedBlocks[i] = assignProfiled(assignFirstDyn, segments, requests[i], callers[i]);
+        printf("Memory requested: %d by caller %d\n", requests[i], callers[i]);
+    }
+    reclaimProfiled(reclaimDyn, segments, allocatedBlocks[1]);
+    printf("Free the block of caller 2\n\n");
+    printList(segments);
+
+    printf("\n");
+    printProfileReport(stdout);
+
+    static allocationProfiler loaded;
+    char path[PATH_MAX];
+    if (temporaryPath(path, sizeof(path), "allocationProfile.bin") == 0) {
+        bool identical = writeProfile(path) == 0 && readProfile(path, &loaded) == 0 &&
+                         loaded.operations == profilerState.operations &&
+                         memcmp(loaded.classes, profilerState.classes, sizeof(loaded.classes)) == 0 &&
+                         memcmp(loaded.callers, profilerState.callers, sizeof(loaded.callers)) == 0;
+        printf("\nProfile written and read back, identical: %s\n", identical ? "yes" : "no");
+        unlink(path);
+    }
+    profilerState.enabled = false;
+}
+
+void test_traceRecorder() {
+    printf("\n========================= TRACE RECORDER =========================\n\n");
+    /* id 7 is reused once reclaimed, as the address of a freed block is */
+    uint64_t ids[6] = {7, 9, 7, 7, 9, 7};
+    uint64_t sizes[6] = {100, 40, RecordedReclaim, 300, RecordedReclaim, RecordedReclaim};
+
+    char path[PATH_MAX];
+    if (temporaryPath(path, sizeof(path), "roundtrip.trace") != 0 || startTraceRecorder(path) != 0) {
+        printf("Could not create a temporary trace\n");
+        return;
+    }
+    for (int i = 0; i < 6; i++) {
+        if (sizes[i] == RecordedReclaim) {
+            recordReclaim(ids[i]);
+        } else {
+            recordAssign(ids[i], sizes[i]);
+        }
+    }
+    stopTraceRecorder();
+
+    size_t length;
+    replayEvent *events = loadRecordedTrace(path, &length);
+    unlink(path);
+    if (events == NULL) {
+        printf("Could not load %s\n", path);
+        return;
+    }
+    bool identical = length == 6;
+    for (size_t i = 0; identical && i < length; i++) {
+        identical = events[i].id == ids[i] && events[i].size == sizes[i];
+    }
+    printf("Recorded 6 events, loaded %zu events, identical: %s\n", length, identical ? "yes" : "no");
+
+    replayResult result;
+    replayRecordedTrace(events, length, 1, assignFirstDyn, &result);
+    printf("Replay with AF: %llu assigned, %llu reclaimed, %llu unmatched, %llu duplicated\n",
+           (unsigned long long)result.assigned, (unsigned long long)result.reclaimed,
+           (unsigned long long)result.unmatched, (unsigned long long)result.duplicated);
+
+    /* the first reclaim of id 7 is moved after its second assign, as in a trace whose events are out of order */
+    replayEvent swapped = events[2];
+    events[2] = events[3];
+    events[3] = swapped;
+    replayRecordedTrace(events, length, 1, assignFirstDyn, &result);
+    printf("Replay with AF, out of order: %llu assigned, %llu reclaimed, %llu unmatched, %llu duplicated\n",
+           (unsigned long long)result.assigned, (unsigned long long)result.reclaimed,
+           (unsigned long long)result.unmatched, (unsigned long long)result.duplicated);
+    free(events);
+}
+
 #endif
\ No newline at end of file
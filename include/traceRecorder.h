@@ -0,0 +1,688 @@
+#ifndef TRACERECORDER
+#define TRACERECORDER
+
+#include <fcntl.h>
+#include <pthread.h>
+#include <sched.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <time.h>
+#include <unistd.h>
+#if defined(__linux__)
+#include <linux/membarrier.h>
+#include <sys/syscall.h>
+#endif
+#include "memorySegment.h"
+#include "dynamicMemoryManagement.h"
+#include "adaptivePolicy.h"
+#include "tester.h"
+
+/**
+ * Recorder of allocation streams. Each thread appends timestamped assign and reclaim events to its own buffer, and full
+ * buffers are handed to a background thread, which compresses and writes them. The recorder never calls malloc, so it
+ * can also record from inside the malloc interposer.
+ *
+ * The trace starts with the 8 bytes "MMTRACE1", followed by one block per buffer: the number of events and the
+ * timestamp of the first one, and then, for each event, the differences of its timestamp and id from the previous
+ * event, and its size plus one (0 marks a reclaim). All numbers are written as LEB128 varints, and the differences are
+ * zigzag encoded. A churn of small blocks from one thread takes about 3.6 bytes per event.
+ */
+
+#define RecorderBufferEvents 4096
+#define MaxRecorderThreads 1024
+#define RecorderOutputSize (1 << 16)
+#define RecordedReclaim UINT64_MAX
+#define RecorderStripeBits 12
+
+typedef struct recordedEvent {
+    uint64_t timestamp;
+    uint64_t id;
+    uint64_t size;
+} recordedEvent;
+
+typedef struct recorderBuffer {
+    struct recorderBuffer *next;
+    uint32_t count;
+    recordedEvent events[RecorderBufferEvents];
+} recorderBuffer;
+
+/**
+ * The recording state of one thread. The thread is busy while it appends an event, and its buffer is only taken from
+ * it by stopTraceRecorder when it is not.
+ */
+typedef struct recorderThread {
+    recorderBuffer *buffer;
+    uint64_t clock;
+    bool busy;
+} recorderThread;
+
+typedef struct traceRecorder {
+    bool active;
+    bool membarrier;
+    bool stopping;
+    int file;
+    pthread_t flusher;
+    pthread_mutex_t lock;
+    pthread_cond_t ready;
+    pthread_key_t threadKey;
+    bool keyCreated;
+    recorderBuffer *full;
+    recorderBuffer *spare;
+    recorderThread *threads[MaxRecorderThreads];
+    uint64_t horizon;
+    uint64_t events;
+    uint64_t bytes;
+    unsigned char output[RecorderOutputSize];
+    size_t outputLength;
+} traceRecorder;
+
+static traceRecorder recorderState = {.file = -1, .lock = PTHREAD_MUTEX_INITIALIZER, .ready = PTHREAD_COND_INITIALIZER};
+static _Thread_local recorderThread threadRecorder = {NULL, 0, false};
+static _Thread_local int threadSlot = -1;
+
+/**
+ * The latest timestamp given to an event of any id that hashes to the stripe.
+ */
+static uint64_t recorderStripes[1 << RecorderStripeBits];
+
+/**
+ * Each thread stamps its events with its own logical clock, so that recording shares no counter between threads.
+ * Replay only needs the events of each id in the order they happened, and those can come from different threads: a
+ * block reclaimed by one thread is assigned again by another one. So the clock of the thread also moves past the
+ * stripe of the id, which the previous event of the id advanced. The reclaim is recorded before the block is released,
+ * and the assign after it is taken, so the allocator orders the two, and the stripe, which only grows, gives the assign
+ * the later timestamp. Different ids only share a cache line when their stripes do.
+ */
+uint64_t recorderTimestamp(uint64_t id) {
+    uint64_t *stripe = &recorderStripes[(id * 0x9e3779b97f4a7c15ull) >> (64 - RecorderStripeBits)];
+    uint64_t seen = __atomic_load_n(stripe, __ATOMIC_RELAXED);
+    uint64_t timestamp = (threadRecorder.clock > seen ? threadRecorder.clock : seen) + 1;
+    threadRecorder.clock = timestamp;
+    while (seen < timestamp &&
+           !__atomic_compare_exchange_n(stripe, &seen, timestamp, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+    }
+    return timestamp;
+}
+
+/**
+ * Orders the store that marks the calling thread busy before its load of the active flag. When stopTraceRecorder can
+ * issue a process wide memory barrier, a compiler barrier is enough here.
+ */
+void recorderFence() {
+    if (recorderState.membarrier) {
+        __atomic_signal_fence(__ATOMIC_SEQ_CST);
+    } else {
+        __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    }
+}
+
+void flushRecorderOutput() {
+    size_t written = 0;
+    while (written < recorderState.outputLength) {
+        ssize_t result = write(recorderState.file, recorderState.output + written,
+                               recorderState.outputLength - written);
+        if (result <= 0) {
+            break;
+        }
+        written += result;
+    }
+    recorderState.bytes += recorderState.outputLength;
+    recorderState.outputLength = 0;
+}
+
+/**
+ * Writes a varint, and returns the end of it. The caller makes sure there is room for it, and for one more byte.
+ */
+unsigned char *writeVarint(unsigned char *output, uint64_t value) {
+    if (value < 0x4000) {
+        /* most values take one or two bytes, and which one is hard to predict, so both are written without a branch */
+        bool twoBytes = value >= 0x80;
+        output[0] = (unsigned char)(value | (uint64_t)twoBytes << 7);
+        output[1] = (unsigned char)(value >> 7);
+        return output + 1 + twoBytes;
+    }
+    while (value >= 0x80) {
+        *output++ = (unsigned char)(value | 0x80);
+        value >>= 7;
+    }
+    *output++ = (unsigned char)value;
+    return output;
+}
+
+uint64_t zigzag(int64_t value) {
+    return ((uint64_t)value << 1) ^ (uint64_t)(value >> 63);
+}
+
+int64_t unzigzag(uint64_t value) {
+    return (int64_t)(value >> 1) ^ -(int64_t)(value & 1);
+}
+
+/**
+ * Compresses one buffer into a block of the trace. Only the background thread writes the trace.
+ */
+void writeBlock(recorderBuffer *buffer) {
+    if (buffer->count == 0) {
+        return;
+    }
+    if (recorderState.outputLength + 20 > RecorderOutputSize) {
+        flushRecorderOutput();
+    }
+    /* the output is written through a local pointer, since every byte stored through the struct would otherwise make
+       the compiler reload outputLength */
+    unsigned char *output = recorderState.output + recorderState.outputLength;
+    unsigned char *limit = recorderState.output + RecorderOutputSize - 30;
+    output = writeVarint(output, buffer->count);
+    output = writeVarint(output, buffer->events[0].timestamp);
+    uint64_t previousTimestamp = buffer->events[0].timestamp;
+    uint64_t previousId = 0;
+    for (uint32_t i = 0; i < buffer->count; i++) {
+        recordedEvent *event = &buffer->events[i];
+        if (output > limit) {
+            recorderState.outputLength = output - recorderState.output;
+            flushRecorderOutput();
+            output = recorderState.output;
+        }
+        output = writeVarint(output, zigzag((int64_t)(event->timestamp - previousTimestamp)));
+        output = writeVarint(output, zigzag((int64_t)(event->id - previousId)));
+        output = writeVarint(output, event->size == RecordedReclaim ? 0 : event->size + 1);
+        previousTimestamp = event->timestamp;
+        previousId = event->id;
+    }
+    recorderState.outputLength = output - recorderState.output;
+    recorderState.events += buffer->count;
+}
+
+void *recorderFlusher(void *argument) {
+    (void)argument;
+    while (true) {
+        pthread_mutex_lock(&recorderState.lock);
+        while (recorderState.full == NULL && !recorderState.stopping) {
+            pthread_cond_wait(&recorderState.ready, &recorderState.lock);
+        }
+        recorderBuffer *full = recorderState.full;
+        recorderState.full = NULL;
+        bool stopping = recorderState.stopping;
+        pthread_mutex_unlock(&recorderState.lock);
+
+        while (full != NULL) {
+            recorderBuffer *next = full->next;
+            writeBlock(full);
+            full->count = 0;
+            pthread_mutex_lock(&recorderState.lock);
+            full->next = recorderState.spare;
+            recorderState.spare = full;
+            pthread_mutex_unlock(&recorderState.lock);
+            full = next;
+        }
+        if (stopping) {
+            flushRecorderOutput();
+            return NULL;
+        }
+    }
+}
+
+/**
+ * Hands a buffer to the background thread. Must be called with the lock held.
+ */
+void submitBuffer(recorderBuffer *buffer) {
+    buffer->next = recorderState.full;
+    recorderState.full = buffer;
+    pthread_cond_signal(&recorderState.ready);
+}
+
+/**
+ * Runs when a recording thread exits, and submits its partially filled buffer, or keeps it for reuse when the
+ * recorder was stopped.
+ */
+void releaseThreadBuffer(void *thread) {
+    (void)thread;
+    pthread_mutex_lock(&recorderState.lock);
+    if (threadSlot >= 0) {
+        recorderState.threads[threadSlot] = NULL;
+        threadSlot = -1;
+    }
+    recorderBuffer *buffer = threadRecorder.buffer;
+    threadRecorder.buffer = NULL;
+    if (buffer != NULL && recorderState.active) {
+        submitBuffer(buffer);
+    } else if (buffer != NULL) {
+        buffer->next = recorderState.spare;
+        recorderState.spare = buffer;
+    }
+    pthread_mutex_unlock(&recorderState.lock);
+}
+
+/**
+ * Gives the calling thread an empty buffer, reusing one that was already written when possible. The clocks of the
+ * threads also catch up with each other here, so that threads that record at different rates stay roughly interleaved.
+ */
+recorderBuffer *takeBuffer() {
+    pthread_mutex_lock(&recorderState.lock);
+    if (threadRecorder.clock < recorderState.horizon) {
+        threadRecorder.clock = recorderState.horizon;
+    }
+    recorderState.horizon = threadRecorder.clock;
+    recorderBuffer *buffer = recorderState.spare;
+    if (buffer != NULL) {
+        recorderState.spare = buffer->next;
+    }
+    if (threadSlot < 0) {
+        for (int i = 0; i < MaxRecorderThreads; i++) {
+            if (recorderState.threads[i] == NULL) {
+                recorderState.threads[i] = &threadRecorder;
+                threadSlot = i;
+                pthread_setspecific(recorderState.threadKey, &threadRecorder);
+                break;
+            }
+        }
+    }
+    pthread_mutex_unlock(&recorderState.lock);
+
+    if (buffer == NULL) {
+        buffer = (recorderBuffer *)mmap(NULL, sizeof(recorderBuffer), PROT_READ | PROT_WRITE,
+                                        MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (buffer == MAP_FAILED) {
+            return NULL;
+        }
+    }
+    buffer->count = 0;
+    buffer->next = NULL;
+    return buffer;
+}
+
+/**
+ * Appends an event to the buffer of the calling thread. The thread marks itself busy before it checks that the
+ * recorder is still active, so that stopTraceRecorder either sees it busy, and waits for it, or it sees the recorder
+ * stopped, and leaves its buffer alone. Being busy also keeps the recorder from recording its own calls to mmap.
+ */
+void recordEvent(uint64_t id, uint64_t size) {
+    if (!__atomic_load_n(&recorderState.active, __ATOMIC_RELAXED) || threadRecorder.busy) {
+        return;
+    }
+    __atomic_store_n(&threadRecorder.busy, true, __ATOMIC_RELAXED);
+    recorderFence();
+    if (__atomic_load_n(&recorderState.active, __ATOMIC_RELAXED)) {
+        if (threadRecorder.buffer == NULL) {
+            threadRecorder.buffer = takeBuffer();
+        }
+        recorderBuffer *buffer = threadRecorder.buffer;
+        if (buffer != NULL) {
+            recordedEvent *event = &buffer->events[buffer->count++];
+            event->timestamp = recorderTimestamp(id);
+            event->id = id;
+            event->size = size;
+            if (buffer->count == RecorderBufferEvents) {
+                pthread_mutex_lock(&recorderState.lock);
+                submitBuffer(buffer);
+                pthread_mutex_unlock(&recorderState.lock);
+                threadRecorder.buffer = takeBuffer();
+            }
+        }
+    }
+    __atomic_store_n(&threadRecorder.busy, false, __ATOMIC_RELEASE);
+}
+
+/**
+ * Records that a block of the given size was assigned to the given id.
+ */
+void recordAssign(uint64_t id, uint64_t size) {
+    recordEvent(id, size);
+}
+
+/**
+ * Records that the block of the given id was reclaimed.
+ */
+void recordReclaim(uint64_t id) {
+    recordEvent(id, RecordedReclaim);
+}
+
+/**
+ * A forked child has no background thread, so it does not record.
+ */
+void disableRecorderInChild() {
+    recorderState.active = false;
+    threadRecorder.buffer = NULL;
+}
+
+/**
+ * Starts recording to a new trace file, and starts the background thread that writes it.
+ *
+ * @param path the trace file.
+ * @return int 0 on success, -1 if the file could not be created.
+ */
+int startTraceRecorder(const char *path) {
+    if (recorderState.active) {
+        return -1;
+    }
+    recorderState.file = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (recorderState.file < 0) {
+        return -1;
+    }
+    if (!recorderState.keyCreated) {
+        pthread_key_create(&recorderState.threadKey, releaseThreadBuffer);
+        pthread_atfork(NULL, NULL, disableRecorderInChild);
+        recorderState.keyCreated = true;
+#if defined(__linux__) && defined(SYS_membarrier)
+        recorderState.membarrier = syscall(SYS_membarrier, MEMBARRIER_CMD_REGISTER_PRIVATE_EXPEDITED, 0) == 0;
+#endif
+    }
+    memcpy(recorderState.output, "MMTRACE1", 8);
+    recorderState.outputLength = 8;
+    recorderState.events = 0;
+    recorderState.bytes = 0;
+    recorderState.stopping = false;
+    recorderState.active = true;
+    if (pthread_create(&recorderState.flusher, NULL, recorderFlusher, NULL) != 0) {
+        recorderState.active = false;
+        close(recorderState.file);
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * Stops recording: the buffers of every recording thread are submitted, and the background thread writes them before
+ * it exits. A thread that is appending an event keeps its buffer until it is done, and the threads that record later
+ * find the recorder stopped.
+ */
+void stopTraceRecorder() {
+    if (!recorderState.active) {
+        return;
+    }
+    __atomic_store_n(&recorderState.active, false, __ATOMIC_SEQ_CST);
+#if defined(__linux__) && defined(SYS_membarrier)
+    if (recorderState.membarrier) {
+        syscall(SYS_membarrier, MEMBARRIER_CMD_PRIVATE_EXPEDITED, 0);
+    }
+#endif
+    bool pending = true;
+    while (pending) {
+        pending = false;
+        pthread_mutex_lock(&recorderState.lock);
+        for (int i = 0; i < MaxRecorderThreads; i++) {
+            recorderThread *thread = recorderState.threads[i];
+            if (thread == NULL) {
+                continue;
+            }
+            if (__atomic_load_n(&thread->busy, __ATOMIC_ACQUIRE)) {
+                pending = true;
+            } else if (thread->buffer != NULL) {
+                submitBuffer(thread->buffer);
+                thread->buffer = NULL;
+            }
+        }
+        if (!pending) {
+            recorderState.stopping = true;
+            pthread_cond_signal(&recorderState.ready);
+        }
+        pthread_mutex_unlock(&recorderState.lock);
+        if (pending) {
+            sched_yield();
+        }
+    }
+    pthread_join(recorderState.flusher, NULL);
+    close(recorderState.file);
+}
+
+/**
+ * The counters of a replay of a recorded trace.
+ */
+typedef struct replayResult {
+    uint64_t assigned;
+    uint64_t failed;
+    uint64_t reclaimed;
+    uint64_t unmatched;
+    uint64_t duplicated;
+    double seconds;
+} replayResult;
+
+typedef struct replayEvent {
+    uint64_t timestamp;
+    uint64_t sequence;
+    uint64_t id;
+    uint64_t size;
+} replayEvent;
+
+int compareReplayEvents(const void *first, const void *second) {
+    const replayEvent *a = (const replayEvent *)first;
+    const replayEvent *b = (const replayEvent *)second;
+    if (a->timestamp != b->timestamp) {
+        return a->timestamp < b->timestamp ? -1 : 1;
+    }
+    return a->sequence < b->sequence ? -1 : (a->sequence > b->sequence ? 1 : 0);
+}
+
+bool readVarint(const unsigned char *data, size_t length, size_t *position, uint64_t *value) {
+    *value = 0;
+    for (int shift = 0; shift < 64 && *position < length; shift += 7) {
+        unsigned char byte = data[(*position)++];
+        *value |= (uint64_t)(byte & 0x7f) << shift;
+        if ((byte & 0x80) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Loads a recorded trace, with the events of all threads merged in the order of their timestamps.
+ *
+ * @param path the trace file.
+ * @param length filled with the number of events.
+ * @return replayEvent* the events, or NULL if the file is not a recorded trace.
+ */
+replayEvent *loadRecordedTrace(const char *path, size_t *length) {
+    FILE *file = fopen(path, "rb");
+    if (file == NULL) {
+        return NULL;
+    }
+    fseek(file, 0, SEEK_END);
+    long fileSize = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    unsigned char *data = (unsigned char *)malloc(fileSize > 0 ? fileSize : 1);
+    size_t dataLength = fread(data, 1, fileSize > 0 ? fileSize : 0, file);
+    fclose(file);
+    if (dataLength < 8 || memcmp(data, "MMTRACE1", 8) != 0) {
+        free(data);
+        return NULL;
+    }
+
+    size_t capacity = 1 << 16;
+    replayEvent *events = (replayEvent *)malloc(capacity * sizeof(replayEvent));
+    *length = 0;
+    size_t position = 8;
+    uint64_t count, timestamp, difference, id, size;
+    while (readVarint(data, dataLength, &position, &count) && readVarint(data, dataLength, &position, &timestamp)) {
+        id = 0;
+        for (uint64_t i = 0; i < count; i++) {
+            if (!readVarint(data, dataLength, &position, &difference)) {
+                break;
+            }
+            timestamp += unzigzag(difference);
+            if (!readVarint(data, dataLength, &position, &difference) ||
+                !readVarint(data, dataLength, &position, &size)) {
+                break;
+            }
+            id += unzigzag(difference);
+            if (*length == capacity) {
+                capacity *= 2;
+                events = (replayEvent *)realloc(events, capacity * sizeof(replayEvent));
+            }
+            events[*length] = (replayEvent){timestamp, *length, id, size == 0 ? RecordedReclaim : size - 1};
+            (*length)++;
+        }
+    }
+    free(data);
+    qsort(events, *length, sizeof(replayEvent), compareReplayEvents);
+    return events;
+}
+
+/**
+ * The blocks assigned during a replay, by the id they were recorded with. Open addressing with linear probing; a
+ * reclaimed entry keeps its id with a NULL block, so that probing continues past it.
+ */
+typedef struct replayTable {
+    uint64_t *ids;
+    memorySegment **blocks;
+    bool *used;
+    size_t capacity;
+    size_t filled;
+} replayTable;
+
+size_t replaySlot(replayTable *table, uint64_t id) {
+    size_t slot = (id * 0x9e3779b97f4a7c15ull) & (table->capacity - 1);
+    while (table->used[slot] && table->ids[slot] != id) {
+        slot = (slot + 1) & (table->capacity - 1);
+    }
+    return slot;
+}
+
+void initializeReplayTable(replayTable *table, size_t capacity) {
+    table->ids = (uint64_t *)malloc(capacity * sizeof(uint64_t));
+    table->blocks = (memorySegment **)malloc(capacity * sizeof(memorySegment *));
+    table->used = (bool *)calloc(capacity, sizeof(bool));
+    table->capacity = capacity;
+    table->filled = 0;
+}
+
+void freeReplayTable(replayTable *table) {
+    free(table->ids);
+    free(table->blocks);
+    free(table->used);
+}
+
+/**
+ * Adds the block assigned to an id. An id that is still assigned means that the trace is corrupt, or that its events
+ * are out of order, so the table is left as it is.
+ *
+ * @return bool false if the id is still assigned to another block.
+ */
+bool insertReplayBlock(replayTable *table, uint64_t id, memorySegment *block) {
+    size_t slot = replaySlot(table, id);
+    if (table->used[slot] && table->blocks[slot] != NULL) {
+        return false;
+    }
+    if (2 * (table->filled + 1) > table->capacity) {
+        replayTable grown;
+        initializeReplayTable(&grown, table->capacity * 2);
+        for (size_t i = 0; i < table->capacity; i++) {
+            if (table->used[i] && table->blocks[i] != NULL) {
+                size_t slot = replaySlot(&grown, table->ids[i]);
+                grown.used[slot] = true;
+                grown.ids[slot] = table->ids[i];
+                grown.blocks[slot] = table->blocks[i];
+                grown.filled++;
+            }
+        }
+        freeReplayTable(table);
+        *table = grown;
+    }
+    slot = replaySlot(table, id);
+    if (!table->used[slot]) {
+        table->used[slot] = true;
+        table->ids[slot] = id;
+        table->filled++;
+    }
+    table->blocks[slot] = block;
+    return true;
+}
+
+/**
+ * Replays recorded events against a fresh dynamic memory, with the given methods of assignement and reclaim. Sizes are
+ * converted to units of the memory by rounding up to a multiple of the granule. An assign to an id that is still
+ * assigned is counted as duplicated, and its block is reclaimed at once.
+ *
+ * @param events the recorded events, in the order of their timestamps.
+ * @param length the number of events.
+ * @param granule the number of bytes in one unit of the memory.
+ * @param assignMemory the method of assignement.
+ * @param result filled with the counters of the replay.
+ */
+void replayRecordedTrace(const replayEvent *events, size_t length, uint64_t granule,
+                         memorySegment *(*assignMemory)(memorySegment *mem, uint16_t size), replayResult *result) {
+    memset(result, 0, sizeof(*result));
+    lastAllocatedBlock = NULL;
+    initializeAdaptivePolicy(DefaultEpochLength, NULL);
+    memorySegment *memList = initializeDynamicMemory(UINT16_MAX);
+    replayTable table;
+    initializeReplayTable(&table, 1 << 12);
+
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (size_t i = 0; i < length; i++) {
+        const replayEvent *event = &events[i];
+        if (event->size == RecordedReclaim) {
+            size_t slot = replaySlot(&table, event->id);
+            if (!table.used[slot] || table.blocks[slot] == NULL) {
+                result->unmatched++;
+                continue;
+            }
+            reclaimDyn(memList, table.blocks[slot]);
+            table.blocks[slot] = NULL;
+            result->reclaimed++;
+            continue;
+        }
+        uint64_t units = (event->size + granule - 1) / granule;
+        memorySegment *block = NULL;
+        if (units <= UINT16_MAX) {
+            block = (*assignMemory)(memList, units > 0 ? (uint16_t)units : 1);
+        }
+        if (block == NULL) {
+            result->failed++;
+            continue;
+        }
+        if (!insertReplayBlock(&table, event->id, block)) {
+            reclaimDyn(memList, block);
+            result->duplicated++;
+            continue;
+        }
+        result->assigned++;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    result->seconds = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+
+    freeReplayTable(&table);
+    freeList(memList);
+}
+
+/**
+ * Replays a recorded trace against the dynamic memory with every method of assignement, and prints one comparison
+ * table.
+ *
+ * @param path the trace file.
+ * @param granule the number of bytes in one unit of the memory, or 0 for the default of 16.
+ */
+void replayRecorded(const char *path, uint64_t granule) {
+    size_t length;
+    replayEvent *events = loadRecordedTrace(path, &length);
+    if (events == NULL) {
+        printf("Error reading recorded trace %s.", path);
+        exit(1);
+    }
+    if (granule == 0) {
+        granule = 16;
+    }
+
+    const char *methodNames[4] = {"AF", "AB", "AN", "AA"};
+    memorySegment *(*dynamicMethods[4]) (memorySegment *memList, uint16_t requestedMem) = {
+        assignFirstDyn, assignBestDyn, assignNextDyn, assignAdaptiveDyn
+    };
+    printf("%zu events, granule %llu bytes\n\n", length, (unsigned long long)granule);
+    printf("%-6s %11s %11s %11s %11s %10s\n", "method", "assigned", "failed", "reclaimed", "unmatched", "time(ms)");
+    uint64_t duplicated = 0;
+    for (int m = 0; m < 4; m++) {
+        replayResult result;
+        replayRecordedTrace(events, length, granule, dynamicMethods[m], &result);
+        printf("%-6s %11llu %11llu %11llu %11llu %10.2f\n", methodNames[m], (unsigned long long)result.assigned,
+               (unsigned long long)result.failed, (unsigned long long)result.reclaimed,
+               (unsigned long long)result.unmatched, 1000.0 * result.seconds);
+        duplicated = result.duplicated;
+    }
+    if (duplicated > 0) {
+        printf("\nError: %llu assigns to ids that were still assigned, the trace is corrupt or out of order.\n",
+               (unsigned long long)duplicated);
+    }
+    free(events);
+}
+
+#endif
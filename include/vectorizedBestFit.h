@@ -0,0 +1,347 @@
+#ifndef VECTORIZEDBESTFIT
+#define VECTORIZEDBESTFIT
+
+#include <string.h>
+#include "memorySegment.h"
+#include "dynamicMemoryManagement.h"
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+/**
+ * Vectorized Best Fit. The lengths of the free blocks of a dynamic memory are kept in a dense array, in the order of
+ * their addresses, next to the blocks themselves. The best fit is found over the array with SIMD compare and minimum
+ * instructions, 8 (SSE4.1) or 16 (AVX2) lengths at a time, with a scalar fallback for other processors. The choice is
+ * the same as the one of assignBestDyn: the first exact fit, or else the last of the smallest blocks that fit.
+ *
+ * Once a memory is indexed, it must only be changed through assignBestVecDyn and reclaimVecDyn, which keep the array in
+ * sync with the list.
+ */
+
+typedef struct freeIndex {
+    uint16_t *lengths;
+    memorySegment **segments;
+    uint32_t count;
+    uint32_t capacity;
+} freeIndex;
+
+typedef int32_t (*bestFitKernel)(const uint16_t *lengths, uint32_t count, uint16_t requestedMem);
+
+/**
+ * Finds the best fit one length at a time. Lengths shorter than the requested memory wrap around to fits larger than
+ * any valid one, so a single unsigned minimum covers both conditions, as in assignBestDyn.
+ *
+ * @return int32_t the position of the best fit in the array, or -1 if no block fits.
+ */
+int32_t bestFitScalar(const uint16_t *lengths, uint32_t count, uint16_t requestedMem) {
+    int32_t best = -1;
+    uint16_t bestFit = UINT16_MAX - requestedMem;
+    for (uint32_t i = 0; i < count; i++) {
+        uint16_t currentFit = lengths[i] - requestedMem;
+        if (currentFit == 0) {
+            return (int32_t)i;
+        }
+        if (currentFit <= bestFit) {
+            bestFit = currentFit;
+            best = (int32_t)i;
+        }
+    }
+    return best;
+}
+
+/**
+ * Finds the position of the chosen length, once the smallest fit is known: the first exact fit, or the last block of
+ * the smallest length.
+ */
+int32_t positionOfFit(const uint16_t *lengths, uint32_t count, uint16_t requestedMem, uint16_t smallestFit) {
+    if (smallestFit > UINT16_MAX - requestedMem) {
+        return -1;
+    }
+    uint16_t length = requestedMem + smallestFit;
+    if (smallestFit == 0) {
+        for (uint32_t i = 0; i < count; i++) {
+            if (lengths[i] == length) {
+                return (int32_t)i;
+            }
+        }
+    } else {
+        for (uint32_t i = count; i > 0; i--) {
+            if (lengths[i - 1] == length) {
+                return (int32_t)(i - 1);
+            }
+        }
+    }
+    return -1;
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+
+__attribute__((target("sse4.1")))
+int32_t bestFitSse41(const uint16_t *lengths, uint32_t count, uint16_t requestedMem) {
+    __m128i requested = _mm_set1_epi16((short)requestedMem);
+    __m128i smallest = _mm_set1_epi16(-1);
+    uint32_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m128i fits = _mm_sub_epi16(_mm_loadu_si128((const __m128i *)(lengths + i)), requested);
+        smallest = _mm_min_epu16(smallest, fits);
+    }
+    uint16_t smallestFit = (uint16_t)_mm_cvtsi128_si32(_mm_minpos_epu16(smallest));
+    for (; i < count; i++) {
+        uint16_t currentFit = lengths[i] - requestedMem;
+        if (currentFit < smallestFit) {
+            smallestFit = currentFit;
+        }
+    }
+    if (smallestFit > UINT16_MAX - requestedMem) {
+        return -1;
+    }
+
+    /* the exact fit is the first one, any other fit is the last one, so the search runs forwards or backwards */
+    __m128i wanted = _mm_set1_epi16((short)(requestedMem + smallestFit));
+    if (smallestFit == 0) {
+        for (i = 0; i + 8 <= count; i += 8) {
+            int mask = _mm_movemask_epi8(_mm_cmpeq_epi16(_mm_loadu_si128((const __m128i *)(lengths + i)), wanted));
+            if (mask != 0) {
+                return (int32_t)(i + __builtin_ctz(mask) / 2);
+            }
+        }
+        return i + positionOfFit(lengths + i, count - i, requestedMem, smallestFit);
+    }
+    for (i = count; i % 8 != 0; i--) {
+        if (lengths[i - 1] == requestedMem + smallestFit) {
+            return (int32_t)(i - 1);
+        }
+    }
+    for (; i > 0; i -= 8) {
+        int mask = _mm_movemask_epi8(_mm_cmpeq_epi16(_mm_loadu_si128((const __m128i *)(lengths + i - 8)), wanted));
+        if (mask != 0) {
+            return (int32_t)(i - 8 + (31 - __builtin_clz(mask)) / 2);
+        }
+    }
+    return -1;
+}
+
+__attribute__((target("avx2")))
+int32_t bestFitAvx2(const uint16_t *lengths, uint32_t count, uint16_t requestedMem) {
+    __m256i requested = _mm256_set1_epi16((short)requestedMem);
+    __m256i smallest = _mm256_set1_epi16(-1);
+    uint32_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        __m256i fits = _mm256_sub_epi16(_mm256_loadu_si256((const __m256i *)(lengths + i)), requested);
+        smallest = _mm256_min_epu16(smallest, fits);
+    }
+    __m128i halves = _mm_min_epu16(_mm256_castsi256_si128(smallest), _mm256_extracti128_si256(smallest, 1));
+    uint16_t smallestFit = (uint16_t)_mm_cvtsi128_si32(_mm_minpos_epu16(halves));
+    for (; i < count; i++) {
+        uint16_t currentFit = lengths[i] - requestedMem;
+        if (currentFit < smallestFit) {
+            smallestFit = currentFit;
+        }
+    }
+    if (smallestFit > UINT16_MAX - requestedMem) {
+        return -1;
+    }
+
+    __m256i wanted = _mm256_set1_epi16((short)(requestedMem + smallestFit));
+    if (smallestFit == 0) {
+        for (i = 0; i + 16 <= count; i += 16) {
+            uint32_t mask = (uint32_t)_mm256_movemask_epi8(
+                _mm256_cmpeq_epi16(_mm256_loadu_si256((const __m256i *)(lengths + i)), wanted));
+            if (mask != 0) {
+                return (int32_t)(i + __builtin_ctz(mask) / 2);
+            }
+        }
+        return i + positionOfFit(lengths + i, count - i, requestedMem, smallestFit);
+    }
+    for (i = count; i % 16 != 0; i--) {
+        if (lengths[i - 1] == requestedMem + smallestFit) {
+            return (int32_t)(i - 1);
+        }
+    }
+    for (; i > 0; i -= 16) {
+        uint32_t mask = (uint32_t)_mm256_movemask_epi8(
+            _mm256_cmpeq_epi16(_mm256_loadu_si256((const __m256i *)(lengths + i - 16)), wanted));
+        if (mask != 0) {
+            return (int32_t)(i - 16 + (31 - __builtin_clz(mask)) / 2);
+        }
+    }
+    return -1;
+}
+
+#endif
+
+/**
+ * The kernel used by assignBestVecDyn, chosen from the instructions the processor supports on first use.
+ */
+static bestFitKernel bestFit = NULL;
+
+const char *bestFitKernelName(bestFitKernel kernel) {
+#if defined(__x86_64__) || defined(__i386__)
+    if (kernel == bestFitAvx2) {
+        return "AVX2";
+    }
+    if (kernel == bestFitSse41) {
+        return "SSE4.1";
+    }
+#endif
+    return "scalar";
+}
+
+bestFitKernel selectBestFitKernel() {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return bestFitAvx2;
+    }
+    if (__builtin_cpu_supports("sse4.1")) {
+        return bestFitSse41;
+    }
+#endif
+    return bestFitScalar;
+}
+
+void reserveFreeIndex(freeIndex *index, uint32_t count) {
+    if (count <= index->capacity) {
+        return;
+    }
+    uint32_t capacity = index->capacity > 0 ? index->capacity : 64;
+    while (capacity < count) {
+        capacity *= 2;
+    }
+    index->lengths = (uint16_t *)realloc(index->lengths, capacity * sizeof(uint16_t));
+    index->segments = (memorySegment **)realloc(index->segments, capacity * sizeof(memorySegment *));
+    index->capacity = capacity;
+}
+
+/**
+ * Indexes the free blocks of a dynamic memory.
+ *
+ * @param index the index to fill.
+ * @param memList the memory as a linked list, with each node representing a memory block.
+ */
+void initializeFreeIndex(freeIndex *index, memorySegment *memList) {
+    memset(index, 0, sizeof(*index));
+    for (memorySegment *currentSegment = memList; currentSegment != NULL; currentSegment = currentSegment->next) {
+        if (!currentSegment->occupied) {
+            reserveFreeIndex(index, index->count + 1);
+            index->lengths[index->count] = currentSegment->length;
+            index->segments[index->count] = currentSegment;
+            index->count++;
+        }
+    }
+}
+
+void freeFreeIndex(freeIndex *index) {
+    free(index->lengths);
+    free(index->segments);
+    memset(index, 0, sizeof(*index));
+}
+
+void removeFreeEntry(freeIndex *index, uint32_t position) {
+    memmove(index->lengths + position, index->lengths + position + 1, (index->count - position - 1) * sizeof(uint16_t));
+    memmove(index->segments + position, index->segments + position + 1,
+            (index->count - position - 1) * sizeof(memorySegment *));
+    index->count--;
+}
+
+void insertFreeEntry(freeIndex *index, uint32_t position, memorySegment *segment) {
+    reserveFreeIndex(index, index->count + 1);
+    memmove(index->lengths + position + 1, index->lengths + position, (index->count - position) * sizeof(uint16_t));
+    memmove(index->segments + position + 1, index->segments + position,
+            (index->count - position) * sizeof(memorySegment *));
+    index->lengths[position] = segment->length;
+    index->segments[position] = segment;
+    index->count++;
+}
+
+/**
+ * Assigns the memory block that both fits the requested memory and is closest to it, like assignBestDyn, but searches
+ * the dense array of free lengths instead of the list.
+ *
+ * @param index the free blocks of the memory.
+ * @param requestedMem the memory requested by a process.
+ * @return memorySegment* the memory block that was allocated by the memory management service.
+ */
+memorySegment *assignBestVecDyn(freeIndex *index, uint16_t requestedMem) {
+    if (bestFit == NULL) {
+        bestFit = selectBestFitKernel();
+    }
+    int32_t position = (*bestFit)(index->lengths, index->count, requestedMem);
+    if (position < 0) {
+        return (NULL);
+    }
+    memorySegment *bestBlock = index->segments[position];
+    splitSegmentDyn(bestBlock, requestedMem);
+
+    /* the free remainder is either a new block in place of the best one, or was added to the next free block */
+    memorySegment *remainder = bestBlock->next;
+    if (bestBlock->length == index->lengths[position]) {
+        removeFreeEntry(index, position);
+    } else if ((uint32_t)position + 1 < index->count && index->segments[position + 1] == remainder) {
+        removeFreeEntry(index, position);
+        index->lengths[position] = remainder->length;
+    } else {
+        index->segments[position] = remainder;
+        index->lengths[position] = remainder->length;
+    }
+    return bestBlock;
+}
+
+/**
+ * Dynamically frees the requested memory block, and concatenates it with its free neighbours, releasing the same nodes
+ * as reclaimDyn. The free neighbours are found in the index, so the list is not walked.
+ *
+ * @param index the free blocks of the memory.
+ * @param thisOne the memory block to reclaim.
+ */
+void reclaimVecDyn(freeIndex *index, memorySegment *thisOne) {
+    uint32_t low = 0, high = index->count;
+    while (low < high) {
+        uint32_t middle = (low + high) / 2;
+        if (index->segments[middle]->startAddress < thisOne->startAddress) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    uint32_t position = low;
+    memorySegment *previousSegment = position > 0 ? index->segments[position - 1] : NULL;
+    bool mergeLeft = previousSegment != NULL &&
+                     previousSegment->startAddress + previousSegment->length == thisOne->startAddress;
+    bool mergeRight = thisOne->next != NULL && thisOne->next->occupied == false;
+
+    thisOne->occupied = false;
+    markFreed(thisOne);
+    if (mergeRight) {
+        memorySegment *mergedSegment = thisOne->next;
+        thisOne->length += mergedSegment->length;
+        mergeFreed(thisOne, mergedSegment->freedAt, mergedSegment->released);
+        thisOne->next = mergedSegment->next;
+        if (lastAllocatedBlock == mergedSegment) {
+            lastAllocatedBlock = thisOne;
+        }
+        releaseSegment(mergedSegment);
+    }
+    if (mergeLeft) {
+        previousSegment->length += thisOne->length;
+        mergeFreed(previousSegment, thisOne->freedAt, thisOne->released);
+        previousSegment->next = thisOne->next;
+        if (lastAllocatedBlock == thisOne) {
+            lastAllocatedBlock = previousSegment;
+        }
+        releaseSegment(thisOne);
+        index->lengths[position - 1] = previousSegment->length;
+        if (mergeRight) {
+            removeFreeEntry(index, position);
+        }
+        return;
+    }
+    if (mergeRight) {
+        index->segments[position] = thisOne;
+        index->lengths[position] = thisOne->length;
+    } else {
+        insertFreeEntry(index, position, thisOne);
+    }
+}
+
+#endif
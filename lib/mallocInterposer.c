@@ -0,0 +1,1052 @@
+/**
+ * Transparent malloc interposer, built as a shared library that can be loaded with LD_PRELOAD. The memory is served
+ * from mmap'd arenas, each one handled as a dynamic memory by the method of assignement chosen with the MM_POLICY
+ * environment variable (AF, AB, AN or AA, First Fit by default). One unit of an arena is a granule of 16 bytes, and
+ * every block starts with a header granule that points back to its memory block. Freed blocks of up to 256 bytes are
+ * kept in per-thread caches. Requests of MM_LARGE_THRESHOLD bytes or more (128 KiB by default, 0 to only map the ones
+ * that do not fit in an arena) are mapped directly, and unmapped as soon as they are freed; MM_HUGE_PAGES=thp or
+ * MM_HUGE_PAGES=explicit backs them with transparent or reserved huge pages. When MM_TRACE names a file, every
+ * allocation and free is recorded to it, with %p in the name replaced by the process id.
+ *
+ * When MM_SCAVENGE_AGE is set, a background scavenger returns the pages of the free blocks that have been idle for that
+ * many milliseconds. It wakes up every MM_SCAVENGE_INTERVAL milliseconds, and releases memory until the resident size
+ * falls to MM_TARGET_RSS bytes, or, without a target, a few megabytes per pass, and every idle page while the memory
+ * pressure of /proc/pressure/memory (some avg10) is at least MM_PRESSURE_THRESHOLD percent.
+ */
+
+#define _GNU_SOURCE
+#include <errno.h>
+#include <fcntl.h>
+#include <malloc.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <time.h>
+#include <unistd.h>
+
+/* the nodes of the memory lists can not be allocated with malloc, so they come from a pool of mmap'd nodes */
+struct memorySegment;
+static struct memorySegment *poolAllocateSegment(void);
+static void poolReleaseSegment(struct memorySegment *segment);
+#define allocateSegment() poolAllocateSegment()
+#define releaseSegment(segment) poolReleaseSegment(segment)
+
+#include "memorySegment.h"
+#include "dynamicMemoryManagement.h"
+#include "adaptivePolicy.h"
+#include "traceRecorder.h"
+
+#define interposed __attribute__((visibility("default")))
+
+#define GranuleSize 16
+#define ArenaUnits UINT16_MAX
+#define ArenaOffset 4096
+#define MaxArenas 4096
+#define SegmentPoolChunk (1 << 16)
+#define SmallClasses 16
+#define SmallCacheLength 64
+#define HeaderMagic 0x4d4d4231u
+#define CachedMagic 0x4d4d4243u
+#define DirectMapping UINT32_MAX
+#define DefaultLargeThreshold (128 * 1024)
+#define DefaultHugePageSize (2 * 1024 * 1024)
+#define HugePageSlack 8
+#define LargeIndexChunk 4096
+#define ArenaBytes (ArenaOffset + (size_t)ArenaUnits * GranuleSize)
+#define ArenaPageWords ((ArenaBytes / 4096 + 64) / 64)
+#define DefaultScavengeInterval 100
+#define DefaultScavengeBudget (4 * 1024 * 1024)
+#define ScavengeBatch 32
+#define DefaultPressureThreshold 10.0
+
+/**
+ * The header granule of a block. For blocks of an arena, the owner is the memory block; for direct mappings, it is the
+ * start of the mapping, whose length is kept in the index of large objects.
+ */
+typedef struct blockHeader {
+    void *owner;
+    uint32_t arena;
+    uint32_t magic;
+} blockHeader;
+
+/**
+ * An arena maps the units of a dynamic memory to addresses, so that the header of the block at unit s lies at
+ * base + ArenaOffset + 16 * (s - 1), and its payload starts at base + ArenaOffset + 16 * s. The payload of a block is
+ * therefore aligned to 16 * 2^k bytes whenever its start address is aligned to 2^k units. The pages released by the
+ * scavenger are marked in releasedPages until a block that covers them is assigned. Under AA, each arena adapts its own
+ * method, from the samples of its own requests.
+ */
+typedef struct arena {
+    char *base;
+    memorySegment *memList;
+    memorySegment *lastAllocated;
+    adaptivePolicy adaptive;
+    uint64_t segmentsVisited;
+    uint64_t releasedPages[ArenaPageWords];
+} arena;
+
+/**
+ * A direct mapping, in the index of large objects, which is sorted by base address.
+ */
+typedef struct largeObject {
+    char *base;
+    size_t length;
+} largeObject;
+
+typedef enum hugePageMode {
+    NO_HUGE_PAGES,
+    TRANSPARENT_HUGE_PAGES,
+    EXPLICIT_HUGE_PAGES
+} hugePageMode;
+
+typedef struct interposerStatistics {
+    uint64_t mallocs;
+    uint64_t frees;
+    uint64_t reallocs;
+    uint64_t reallocsInPlace;
+    uint64_t alignedAllocs;
+    uint64_t smallCacheHits;
+    uint64_t directMappings;
+    uint64_t hugePageMappings;
+    uint64_t peakLargeObjects;
+    uint64_t segments;
+    uint64_t peakSegments;
+    uint64_t scavengePasses;
+    uint64_t releasedBytes;
+    uint64_t refaultedBytes;
+    uint64_t failures;
+    uint64_t doubleFrees;
+} interposerStatistics;
+
+/**
+ * The freed small blocks of a thread, linked through their payloads. They remain occupied in their arena, with
+ * CachedMagic in their headers, so that freeing one of them again is detected.
+ */
+typedef struct smallCache {
+    void *blocks[SmallClasses + 1];
+    uint32_t lengths[SmallClasses + 1];
+    bool registered;
+} smallCache;
+
+static pthread_mutex_t interposerLock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_mutex_t largeObjectLock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_once_t interposerOnce = PTHREAD_ONCE_INIT;
+static pthread_key_t cacheKey;
+static arena arenas[MaxArenas];
+static uint32_t arenaCount = 0;
+static uint32_t currentArena = 0;
+static memorySegment *segmentPool = NULL;
+static memorySegment *(*assignMethod)(memorySegment *memList, uint16_t requestedMem) = assignFirstDyn;
+static memorySegment *(*assignAlignedMethod)(memorySegment *memList, uint16_t requestedMem, uint16_t alignment) =
+    assignFirstAlignedDyn;
+static const char *methodInUse = "AF";
+static bool wrapsAround = false;
+static size_t pageSize = 4096;
+static size_t largeThreshold = DefaultLargeThreshold;
+static hugePageMode hugePages = NO_HUGE_PAGES;
+static size_t hugePageSize = DefaultHugePageSize;
+static bool scavengerRunning = false;
+static uint32_t scavengeInterval = DefaultScavengeInterval;
+static uint16_t scavengeAge = 1;
+static size_t targetRss = 0;
+static double pressureThreshold = DefaultPressureThreshold;
+static largeObject *largeObjects = NULL;
+static size_t largeObjectCount = 0;
+static size_t largeObjectCapacity = 0;
+static interposerStatistics interposerStats;
+static _Thread_local smallCache threadCache;
+
+#define countEvent(counter) __atomic_fetch_add(&interposerStats.counter, 1, __ATOMIC_RELAXED)
+
+static memorySegment *poolAllocateSegment(void) {
+    if (segmentPool == NULL) {
+        memorySegment *nodes = (memorySegment *)mmap(NULL, SegmentPoolChunk, PROT_READ | PROT_WRITE,
+                                                     MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (nodes == MAP_FAILED) {
+            abort();
+        }
+        for (size_t i = 0; i < SegmentPoolChunk / sizeof(memorySegment); i++) {
+            nodes[i].next = segmentPool;
+            segmentPool = &nodes[i];
+        }
+    }
+    memorySegment *segment = segmentPool;
+    segmentPool = segment->next;
+    /* every node in use belongs to the list of an arena, so this counts the length of all the lists */
+    if (++interposerStats.segments > interposerStats.peakSegments) {
+        interposerStats.peakSegments = interposerStats.segments;
+    }
+    return segment;
+}
+
+static void poolReleaseSegment(struct memorySegment *segment) {
+    segment->next = segmentPool;
+    segmentPool = segment;
+    interposerStats.segments--;
+}
+
+static blockHeader *headerOf(void *pointer) {
+    return (blockHeader *)pointer - 1;
+}
+
+static char *addressOf(uint32_t index, uint32_t unit) {
+    return arenas[index].base + ArenaOffset - GranuleSize + (size_t)unit * GranuleSize;
+}
+
+/**
+ * Counts the released pages that an assigned block covers as re-faulted, since they fault in again once the block is
+ * written. Must be called with the lock held.
+ */
+static void refaultReleasedPages(uint32_t index, memorySegment *segment) {
+    if (!scavengerRunning) {
+        return;
+    }
+    arena *current = &arenas[index];
+    size_t first = (addressOf(index, segment->startAddress) - current->base) / pageSize;
+    size_t last = (addressOf(index, segment->startAddress + segment->length) - 1 - current->base) / pageSize;
+    for (size_t page = first; page <= last; page++) {
+        uint64_t bit = 1ull << (page % 64);
+        if (current->releasedPages[page / 64] & bit) {
+            current->releasedPages[page / 64] &= ~bit;
+            interposerStats.refaultedBytes += pageSize;
+        }
+    }
+}
+
+static void *payloadOf(uint32_t index, memorySegment *segment) {
+    refaultReleasedPages(index, segment);
+    blockHeader *header = (blockHeader *)addressOf(index, segment->startAddress);
+    header->owner = segment;
+    header->arena = index;
+    header->magic = HeaderMagic;
+    return header + 1;
+}
+
+static size_t largeObjectLength(char *base);
+
+static size_t usableSize(blockHeader *header) {
+    if (header->arena == DirectMapping) {
+        char *base = (char *)header->owner;
+        return base + largeObjectLength(base) - (char *)(header + 1);
+    }
+    return ((size_t)((memorySegment *)header->owner)->length - 1) * GranuleSize;
+}
+
+/**
+ * The number of units a request occupies in an arena, including its header, or 0 if it does not fit in one.
+ */
+static uint32_t unitsOf(size_t size) {
+    if (size > ((size_t)ArenaUnits - 1) * GranuleSize) {
+        return 0;
+    }
+    size_t payload = (size + GranuleSize - 1) / GranuleSize;
+    return (uint32_t)(payload > 0 ? payload : 1) + 1;
+}
+
+static void flushThreadCache(void *cache);
+
+static void lockBeforeFork(void) {
+    pthread_mutex_lock(&interposerLock);
+    pthread_mutex_lock(&largeObjectLock);
+}
+
+static void unlockAfterFork(void) {
+    pthread_mutex_unlock(&largeObjectLock);
+    pthread_mutex_unlock(&interposerLock);
+}
+
+/**
+ * Reads the size of the reserved huge pages from /proc/meminfo, without allocating.
+ */
+static void readHugePageSize(void) {
+    int file = open("/proc/meminfo", O_RDONLY);
+    if (file < 0) {
+        return;
+    }
+    char buffer[4096];
+    ssize_t length = read(file, buffer, sizeof(buffer) - 1);
+    close(file);
+    if (length <= 0) {
+        return;
+    }
+    buffer[length] = '\0';
+    char *line = strstr(buffer, "Hugepagesize:");
+    if (line != NULL) {
+        size_t kilobytes = strtoull(line + strlen("Hugepagesize:"), NULL, 10);
+        if (kilobytes > 0) {
+            hugePageSize = kilobytes * 1024;
+        }
+    }
+}
+
+static void initializeInterposer(void) {
+    const char *policy = getenv("MM_POLICY");
+    if (policy != NULL && strcmp(policy, "AB") == 0) {
+        assignMethod = assignBestDyn;
+        assignAlignedMethod = assignBestAlignedDyn;
+        methodInUse = "AB";
+    } else if (policy != NULL && strcmp(policy, "AN") == 0) {
+        assignMethod = assignNextDyn;
+        assignAlignedMethod = assignNextAlignedDyn;
+        methodInUse = "AN";
+        wrapsAround = true;
+    } else if (policy != NULL && strcmp(policy, "AA") == 0) {
+        assignMethod = assignAdaptiveDyn;
+        assignAlignedMethod = assignAdaptiveAlignedDyn;
+        methodInUse = "AA";
+    }
+    long size = sysconf(_SC_PAGESIZE);
+    if (size > 0) {
+        pageSize = (size_t)size;
+    }
+    const char *threshold = getenv("MM_LARGE_THRESHOLD");
+    if (threshold != NULL && threshold[0] != '\0') {
+        largeThreshold = strtoull(threshold, NULL, 10);
+    }
+    const char *huge = getenv("MM_HUGE_PAGES");
+    if (huge != NULL && strcmp(huge, "thp") == 0) {
+        hugePages = TRANSPARENT_HUGE_PAGES;
+    } else if (huge != NULL && strcmp(huge, "explicit") == 0) {
+        hugePages = EXPLICIT_HUGE_PAGES;
+    }
+    if (hugePages != NO_HUGE_PAGES) {
+        readHugePageSize();
+    }
+    pthread_key_create(&cacheKey, flushThreadCache);
+    pthread_atfork(lockBeforeFork, unlockAfterFork, unlockAfterFork);
+}
+
+static bool createArena(void) {
+    if (arenaCount == MaxArenas) {
+        return false;
+    }
+    char *base = (char *)mmap(NULL, ArenaOffset + (size_t)ArenaUnits * GranuleSize, PROT_READ | PROT_WRITE,
+                              MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (base == MAP_FAILED) {
+        return false;
+    }
+    memorySegment *memList = createSegment(0, ArenaUnits, false);
+    memList->freedAt = __atomic_load_n(&reclaimClock, __ATOMIC_RELAXED);
+    memset(arenas[arenaCount].releasedPages, 0, sizeof(arenas[arenaCount].releasedPages));
+    arenas[arenaCount].base = base;
+    arenas[arenaCount].memList = memList;
+    arenas[arenaCount].lastAllocated = NULL;
+    arenas[arenaCount].adaptive = (adaptivePolicy){FIRST_FIT, DefaultEpochLength, 0, 0, 0, 0, 0, FIRST_FIT, 0, 0,
+                                                   NULL};
+    arenas[arenaCount].segmentsVisited = 0;
+    arenaCount++;
+    return true;
+}
+
+/**
+ * Loads the state that the methods keep between requests, which belongs to the arena rather than to the calling thread:
+ * the resume point of Next Fit, and the samples of the adaptive method. Must be called with the lock held.
+ */
+static void enterArena(arena *current) {
+    lastAllocatedBlock = current->lastAllocated;
+    if (assignMethod == assignAdaptiveDyn) {
+        adaptiveState = current->adaptive;
+        segmentsVisited = current->segmentsVisited;
+    }
+}
+
+static void leaveArena(arena *current) {
+    current->lastAllocated = lastAllocatedBlock;
+    if (assignMethod == assignAdaptiveDyn) {
+        current->adaptive = adaptiveState;
+        current->segmentsVisited = segmentsVisited;
+    }
+}
+
+static memorySegment *assignInArena(arena *current, uint32_t units, uint16_t alignmentUnits) {
+    if (alignmentUnits > 1) {
+        return (*assignAlignedMethod)(current->memList, units, alignmentUnits);
+    }
+    return (*assignMethod)(current->memList, units);
+}
+
+/**
+ * Assigns a block from the arenas, starting with the one that served the last request, and creating a new arena when
+ * none of them has a block that fits. Must be called with the lock held.
+ */
+static void *assignFromArenas(uint32_t units, uint16_t alignmentUnits) {
+    for (uint32_t tried = 0; tried <= arenaCount; tried++) {
+        uint32_t index;
+        if (tried < arenaCount) {
+            index = (currentArena + tried) % arenaCount;
+        } else if (createArena()) {
+            index = arenaCount - 1;
+        } else {
+            return NULL;
+        }
+        arena *current = &arenas[index];
+        /* Next Fit resumes from the last block allocated in this arena, and wraps around to its head */
+        enterArena(current);
+        memorySegment *segment = assignInArena(current, units, alignmentUnits);
+        if (segment == NULL && wrapsAround && current->lastAllocated != NULL) {
+            lastAllocatedBlock = NULL;
+            segment = assignInArena(current, units, alignmentUnits);
+        }
+        leaveArena(current);
+        if (segment != NULL) {
+            currentArena = index;
+            return payloadOf(index, segment);
+        }
+    }
+    return NULL;
+}
+
+/**
+ * Must be called with the lock held.
+ */
+static void reclaimFromArena(blockHeader *header) {
+    arena *current = &arenas[header->arena];
+    header->magic = 0;
+    enterArena(current);
+    reclaimDyn(current->memList, (memorySegment *)header->owner);
+    leaveArena(current);
+}
+
+static void flushThreadCache(void *cache) {
+    smallCache *threadCache = (smallCache *)cache;
+    pthread_mutex_lock(&interposerLock);
+    for (int i = 1; i <= SmallClasses; i++) {
+        while (threadCache->blocks[i] != NULL) {
+            void *pointer = threadCache->blocks[i];
+            threadCache->blocks[i] = *(void **)pointer;
+            reclaimFromArena(headerOf(pointer));
+        }
+        threadCache->lengths[i] = 0;
+    }
+    pthread_mutex_unlock(&interposerLock);
+}
+
+static bool isLarge(size_t size) {
+    return largeThreshold > 0 && size >= largeThreshold;
+}
+
+/**
+ * The position of a direct mapping in the index of large objects, or of the first one after it if it is not there. Must
+ * be called with the lock of the index held.
+ */
+static size_t largeObjectPosition(char *base) {
+    size_t low = 0, high = largeObjectCount;
+    while (low < high) {
+        size_t middle = (low + high) / 2;
+        if (largeObjects[middle].base < base) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    return low;
+}
+
+/**
+ * Adds a direct mapping to the index of large objects, growing the index with a new mapping when it is full.
+ */
+static bool indexLargeObject(char *base, size_t length) {
+    pthread_mutex_lock(&largeObjectLock);
+    if (largeObjectCount == largeObjectCapacity) {
+        size_t capacity = largeObjectCapacity + LargeIndexChunk;
+        largeObject *grown = (largeObject *)mmap(NULL, capacity * sizeof(largeObject), PROT_READ | PROT_WRITE,
+                                                 MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (grown == MAP_FAILED) {
+            pthread_mutex_unlock(&largeObjectLock);
+            return false;
+        }
+        if (largeObjects != NULL) {
+            memcpy(grown, largeObjects, largeObjectCount * sizeof(largeObject));
+            munmap(largeObjects, largeObjectCapacity * sizeof(largeObject));
+        }
+        largeObjects = grown;
+        largeObjectCapacity = capacity;
+    }
+    size_t low = largeObjectPosition(base);
+    memmove(&largeObjects[low + 1], &largeObjects[low], (largeObjectCount - low) * sizeof(largeObject));
+    largeObjects[low] = (largeObject){base, length};
+    if (++largeObjectCount > interposerStats.peakLargeObjects) {
+        interposerStats.peakLargeObjects = largeObjectCount;
+    }
+    pthread_mutex_unlock(&largeObjectLock);
+    return true;
+}
+
+/**
+ * Removes a direct mapping from the index of large objects.
+ *
+ * @return size_t the length of the mapping, or 0 if it is not in the index.
+ */
+static size_t unindexLargeObject(char *base) {
+    pthread_mutex_lock(&largeObjectLock);
+    size_t low = largeObjectPosition(base);
+    size_t length = 0;
+    if (low < largeObjectCount && largeObjects[low].base == base) {
+        length = largeObjects[low].length;
+        memmove(&largeObjects[low], &largeObjects[low + 1], (largeObjectCount - low - 1) * sizeof(largeObject));
+        largeObjectCount--;
+    }
+    pthread_mutex_unlock(&largeObjectLock);
+    return length;
+}
+
+/**
+ * The length of a direct mapping, as kept in the index of large objects, or 0 if it is not in the index.
+ */
+static size_t largeObjectLength(char *base) {
+    pthread_mutex_lock(&largeObjectLock);
+    size_t low = largeObjectPosition(base);
+    size_t length = low < largeObjectCount && largeObjects[low].base == base ? largeObjects[low].length : 0;
+    pthread_mutex_unlock(&largeObjectLock);
+    return length;
+}
+
+/**
+ * Maps the pages of a direct mapping. Reserved huge pages are only used when rounding the mapping up to whole huge
+ * pages wastes less than 1 / HugePageSlack of it. Transparent huge pages need no rounding: the mapping starts on a huge
+ * page boundary, so that every whole huge page inside it can be backed by one, and its tail stays on base pages.
+ */
+static char *mapPages(size_t *length) {
+    size_t hugeLength = (*length + hugePageSize - 1) / hugePageSize * hugePageSize;
+    if (hugePages == EXPLICIT_HUGE_PAGES && hugeLength - *length < hugeLength / HugePageSlack) {
+        char *base = (char *)mmap(NULL, hugeLength, PROT_READ | PROT_WRITE,
+                                  MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (base != MAP_FAILED) {
+            *length = hugeLength;
+            countEvent(hugePageMappings);
+            return base;
+        }
+    }
+    if (hugePages == TRANSPARENT_HUGE_PAGES && *length >= hugePageSize) {
+        char *mapping = (char *)mmap(NULL, *length + hugePageSize, PROT_READ | PROT_WRITE,
+                                     MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (mapping != MAP_FAILED) {
+            char *base = (char *)(((uintptr_t)mapping + hugePageSize - 1) & ~(uintptr_t)(hugePageSize - 1));
+            if (base > mapping) {
+                munmap(mapping, base - mapping);
+            }
+            munmap(base + *length, mapping + hugePageSize - base);
+            if (madvise(base, *length, MADV_HUGEPAGE) == 0) {
+                countEvent(hugePageMappings);
+            }
+            return base;
+        }
+    }
+    char *base = (char *)mmap(NULL, *length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    return base == MAP_FAILED ? NULL : base;
+}
+
+/**
+ * Maps a large object directly. Its header granule lies at the start of the mapping, or just before the payload when
+ * the payload has to be aligned further, so the mapping only rounds the header and the payload up to whole pages.
+ */
+static void *mapDirect(size_t size, size_t alignment) {
+    size_t offset = alignment > GranuleSize ? alignment : GranuleSize;
+    if (size > SIZE_MAX - offset - pageSize) {
+        return NULL;
+    }
+    size_t length = (offset + size + pageSize - 1) / pageSize * pageSize;
+    char *base = mapPages(&length);
+    if (base == NULL) {
+        return NULL;
+    }
+    if (!indexLargeObject(base, length)) {
+        munmap(base, length);
+        return NULL;
+    }
+    char *payload = (char *)(((uintptr_t)base + GranuleSize + offset - 1) & ~(uintptr_t)(offset - 1));
+    blockHeader *header = headerOf(payload);
+    header->owner = base;
+    header->arena = DirectMapping;
+    header->magic = HeaderMagic;
+    countEvent(directMappings);
+    return payload;
+}
+
+static void unmapDirect(blockHeader *header) {
+    header->magic = 0;
+    size_t length = unindexLargeObject((char *)header->owner);
+    if (length > 0) {
+        munmap(header->owner, length);
+    }
+}
+
+static void *assignBlock(size_t size, size_t alignment) {
+    pthread_once(&interposerOnce, initializeInterposer);
+    uint32_t units = unitsOf(size);
+    if (units == 0 || alignment > pageSize || isLarge(size)) {
+        void *pointer = mapDirect(size, alignment);
+        if (pointer == NULL) {
+            countEvent(failures);
+            errno = ENOMEM;
+        }
+        return pointer;
+    }
+
+    uint32_t payloadUnits = units - 1;
+    if (alignment <= GranuleSize && payloadUnits <= SmallClasses && threadCache.blocks[payloadUnits] != NULL) {
+        void *pointer = threadCache.blocks[payloadUnits];
+        threadCache.blocks[payloadUnits] = *(void **)pointer;
+        threadCache.lengths[payloadUnits]--;
+        headerOf(pointer)->magic = HeaderMagic;
+        countEvent(smallCacheHits);
+        return pointer;
+    }
+
+    pthread_mutex_lock(&interposerLock);
+    void *pointer = assignFromArenas(units, alignment > GranuleSize ? alignment / GranuleSize : 1);
+    pthread_mutex_unlock(&interposerLock);
+    if (pointer == NULL) {
+        countEvent(failures);
+        errno = ENOMEM;
+    }
+    return pointer;
+}
+
+static void *allocate(size_t size, size_t alignment) {
+    void *pointer = assignBlock(size, alignment);
+    if (pointer != NULL) {
+        recordAssign((uintptr_t)pointer, size);
+    }
+    return pointer;
+}
+
+static void *allocateAligned(size_t alignment, size_t size) {
+    if (alignment == 0 || (alignment & (alignment - 1)) != 0) {
+        errno = EINVAL;
+        return NULL;
+    }
+    countEvent(alignedAllocs);
+    return allocate(size, alignment);
+}
+
+interposed void *malloc(size_t size) {
+    countEvent(mallocs);
+    return allocate(size, GranuleSize);
+}
+
+interposed void free(void *pointer) {
+    if (pointer == NULL) {
+        return;
+    }
+    blockHeader *header = headerOf(pointer);
+    if (header->magic != HeaderMagic) {
+        /* a block that is already in a small cache would be handed out twice if it were cached again */
+        if (header->magic == CachedMagic) {
+            countEvent(doubleFrees);
+        }
+        return;
+    }
+    countEvent(frees);
+    recordReclaim((uintptr_t)pointer);
+    if (header->arena == DirectMapping) {
+        unmapDirect(header);
+        return;
+    }
+
+    uint16_t payloadUnits = ((memorySegment *)header->owner)->length - 1;
+    if (payloadUnits <= SmallClasses && threadCache.lengths[payloadUnits] < SmallCacheLength) {
+        if (!threadCache.registered) {
+            pthread_once(&interposerOnce, initializeInterposer);
+            pthread_setspecific(cacheKey, &threadCache);
+            threadCache.registered = true;
+        }
+        header->magic = CachedMagic;
+        *(void **)pointer = threadCache.blocks[payloadUnits];
+        threadCache.blocks[payloadUnits] = pointer;
+        threadCache.lengths[payloadUnits]++;
+        return;
+    }
+
+    pthread_mutex_lock(&interposerLock);
+    reclaimFromArena(header);
+    pthread_mutex_unlock(&interposerLock);
+}
+
+interposed void *calloc(size_t number, size_t size) {
+    size_t total;
+    if (__builtin_mul_overflow(number, size, &total)) {
+        errno = ENOMEM;
+        return NULL;
+    }
+    countEvent(mallocs);
+    void *pointer = allocate(total, GranuleSize);
+    if (pointer != NULL && headerOf(pointer)->arena != DirectMapping) {
+        memset(pointer, 0, total);
+    }
+    return pointer;
+}
+
+interposed void *realloc(void *pointer, size_t size) {
+    if (pointer == NULL) {
+        return malloc(size);
+    }
+    if (size == 0) {
+        free(pointer);
+        return NULL;
+    }
+    countEvent(reallocs);
+    blockHeader *header = headerOf(pointer);
+    size_t oldSize = usableSize(header);
+    uint32_t units = unitsOf(size);
+
+    if (header->arena != DirectMapping && units != 0 && !isLarge(size)) {
+        pthread_mutex_lock(&interposerLock);
+        arena *current = &arenas[header->arena];
+        uint32_t index = header->arena;
+        memorySegment *segment = (memorySegment *)header->owner;
+        enterArena(current);
+        memorySegment *resized = resizeDyn(current->memList, segment, units, assignMethod);
+        leaveArena(current);
+        if (resized == segment) {
+            refaultReleasedPages(index, segment);
+            pthread_mutex_unlock(&interposerLock);
+            countEvent(reallocsInPlace);
+            recordReclaim((uintptr_t)pointer);
+            recordAssign((uintptr_t)pointer, size);
+            return pointer;
+        }
+        if (resized != NULL) {
+            /* the old block was reclaimed, but nothing can reuse its memory before the lock is released, so both
+               events are recorded first, and are ordered before the assign of any thread that reuses the old block */
+            header->magic = 0;
+            void *relocated = payloadOf(index, resized);
+            memcpy(relocated, pointer, oldSize < size ? oldSize : size);
+            recordReclaim((uintptr_t)pointer);
+            recordAssign((uintptr_t)relocated, size);
+            pthread_mutex_unlock(&interposerLock);
+            return relocated;
+        }
+        pthread_mutex_unlock(&interposerLock);
+    } else if (header->arena == DirectMapping && size <= oldSize) {
+        countEvent(reallocsInPlace);
+        recordReclaim((uintptr_t)pointer);
+        recordAssign((uintptr_t)pointer, size);
+        return pointer;
+    }
+
+    void *relocated = allocate(size, GranuleSize);
+    if (relocated == NULL) {
+        return NULL;
+    }
+    memcpy(relocated, pointer, oldSize < size ? oldSize : size);
+    free(pointer);
+    return relocated;
+}
+
+interposed void *reallocarray(void *pointer, size_t number, size_t size) {
+    size_t total;
+    if (__builtin_mul_overflow(number, size, &total)) {
+        errno = ENOMEM;
+        return NULL;
+    }
+    return realloc(pointer, total);
+}
+
+interposed int posix_memalign(void **memptr, size_t alignment, size_t size) {
+    /* the alignment is validated before any allocation, so that an invalid one is never reported as ENOMEM */
+    if (alignment == 0 || alignment % sizeof(void *) != 0 || (alignment & (alignment - 1)) != 0) {
+        return EINVAL;
+    }
+    void *pointer = allocateAligned(alignment, size);
+    if (pointer == NULL) {
+        return ENOMEM;
+    }
+    *memptr = pointer;
+    return 0;
+}
+
+interposed void *aligned_alloc(size_t alignment, size_t size) {
+    return allocateAligned(alignment, size);
+}
+
+interposed void *memalign(size_t alignment, size_t size) {
+    return allocateAligned(alignment, size);
+}
+
+interposed void *valloc(size_t size) {
+    pthread_once(&interposerOnce, initializeInterposer);
+    return allocateAligned(pageSize, size);
+}
+
+interposed void *pvalloc(size_t size) {
+    pthread_once(&interposerOnce, initializeInterposer);
+    return allocateAligned(pageSize, (size + pageSize - 1) / pageSize * pageSize);
+}
+
+interposed size_t malloc_usable_size(void *pointer) {
+    if (pointer == NULL || headerOf(pointer)->magic != HeaderMagic) {
+        return 0;
+    }
+    return usableSize(headerOf(pointer));
+}
+
+/**
+ * Starts recording when MM_TRACE is set. The recorder starts its background thread, so this can not be done from the
+ * first malloc, which runs the initialization of the interposer.
+ */
+__attribute__((constructor)) static void startInterposerTrace(void) {
+    pthread_once(&interposerOnce, initializeInterposer);
+    const char *path = getenv("MM_TRACE");
+    if (path == NULL || path[0] == '\0') {
+        return;
+    }
+    static char tracePath[4096];
+    const char *process = strstr(path, "%p");
+    if (process != NULL) {
+        snprintf(tracePath, sizeof(tracePath), "%.*s%d%s", (int)(process - path), path, (int)getpid(), process + 2);
+        path = tracePath;
+    }
+    startTraceRecorder(path);
+}
+
+/**
+ * Reads a small file of /proc into the buffer, without allocating.
+ */
+static bool readProcFile(const char *path, char *buffer, size_t size) {
+    int file = open(path, O_RDONLY);
+    if (file < 0) {
+        return false;
+    }
+    ssize_t length = read(file, buffer, size - 1);
+    close(file);
+    if (length <= 0) {
+        return false;
+    }
+    buffer[length] = '\0';
+    return true;
+}
+
+static size_t residentBytes(void) {
+    char buffer[128];
+    if (!readProcFile("/proc/self/statm", buffer, sizeof(buffer))) {
+        return 0;
+    }
+    char *resident;
+    strtoull(buffer, &resident, 10);
+    return strtoull(resident, NULL, 10) * pageSize;
+}
+
+/**
+ * The share of the last 10 seconds in which some task stalled on memory, or -1 when the kernel does not report it.
+ */
+static double memoryPressure(void) {
+    char buffer[256];
+    if (!readProcFile("/proc/pressure/memory", buffer, sizeof(buffer))) {
+        return -1;
+    }
+    char *average = strstr(buffer, "some avg10=");
+    return average != NULL ? strtod(average + strlen("some avg10="), NULL) : -1;
+}
+
+/**
+ * The number of bytes the scavenger may release in one pass: the excess over the target resident size when there is
+ * one, and otherwise everything under memory pressure, or a few megabytes.
+ */
+static size_t scavengeBudget(void) {
+    if (targetRss > 0) {
+        size_t resident = residentBytes();
+        return resident > targetRss ? resident - targetRss : 0;
+    }
+    return memoryPressure() >= pressureThreshold ? SIZE_MAX : DefaultScavengeBudget;
+}
+
+/**
+ * A free block that the scavenger holds while it releases the pages from firstPage to endPage of its arena.
+ */
+typedef struct scavengeClaim {
+    memorySegment *segment;
+    uint16_t freedAt;
+    size_t firstPage;
+    size_t endPage;
+    bool whole;
+} scavengeClaim;
+
+/**
+ * Claims a batch of the free blocks of an arena that have been idle long enough, from the given unit on, for the
+ * scavenger to release the whole pages inside them. A claimed block is marked occupied, so that no request is assigned
+ * it and no neighbour is concatenated with it while the lock is released. The headers of the neighbouring blocks lie
+ * outside of these pages, so they are never released. Must be called with the lock held.
+ *
+ * @param index the arena.
+ * @param start the unit where the search starts, moved past the last block claimed.
+ * @param budget the bytes that may still be released, reduced by the pages claimed.
+ * @param claims filled with the claimed blocks.
+ * @return int the number of blocks claimed.
+ */
+static int claimIdleBlocks(uint32_t index, uint32_t *start, size_t *budget, scavengeClaim *claims) {
+    arena *current = &arenas[index];
+    uint16_t now = __atomic_load_n(&reclaimClock, __ATOMIC_RELAXED);
+    int count = 0;
+    for (memorySegment *segment = current->memList; segment != NULL && *budget > 0 && count < ScavengeBatch;
+         segment = segment->next) {
+        if (segment->startAddress < *start || segment->occupied || segment->released ||
+            (uint16_t)(now - segment->freedAt) < scavengeAge) {
+            continue;
+        }
+        *start = (uint32_t)segment->startAddress + segment->length;
+        size_t first = (addressOf(index, segment->startAddress) - current->base + pageSize - 1) / pageSize;
+        size_t end = (addressOf(index, segment->startAddress + segment->length) - current->base) / pageSize;
+        if (first >= end) {
+            segment->released = true;
+            continue;
+        }
+        size_t page = first;
+        for (; page < end && *budget > 0; page++) {
+            if (!(current->releasedPages[page / 64] & (1ull << (page % 64)))) {
+                *budget = *budget > pageSize ? *budget - pageSize : 0;
+            }
+        }
+        claims[count++] = (scavengeClaim){segment, segment->freedAt, first, page, page >= end};
+        segment->occupied = true;
+    }
+    return count;
+}
+
+/**
+ * Gives back the blocks claimed by claimIdleBlocks, with their pages marked released when madvise succeeded. Nothing
+ * else assigns or concatenates a claimed block, so each one is still as it was claimed. Must be called with the lock
+ * held.
+ */
+static void returnClaimedBlocks(uint32_t index, scavengeClaim *claims, int count, const bool *released) {
+    arena *current = &arenas[index];
+    enterArena(current);
+    for (int i = 0; i < count; i++) {
+        scavengeClaim *claim = &claims[i];
+        for (size_t page = claim->firstPage; released[i] && page < claim->endPage; page++) {
+            uint64_t bit = 1ull << (page % 64);
+            if (!(current->releasedPages[page / 64] & bit)) {
+                current->releasedPages[page / 64] |= bit;
+                interposerStats.releasedBytes += pageSize;
+            }
+        }
+        reclaimDatedDyn(current->memList, claim->segment, claim->freedAt, released[i] && claim->whole);
+    }
+    leaveArena(current);
+}
+
+/**
+ * Releases the whole pages inside the free blocks of an arena that have been idle long enough, a batch of blocks at a
+ * time. The lock is held to claim the blocks and to give them back, but not while madvise runs.
+ *
+ * @return bool false if there is no arena of that index.
+ */
+static bool scavengeArena(uint32_t index, size_t *budget) {
+    scavengeClaim claims[ScavengeBatch];
+    bool released[ScavengeBatch];
+    uint32_t start = 0;
+    while (*budget > 0) {
+        pthread_mutex_lock(&interposerLock);
+        if (index >= arenaCount) {
+            pthread_mutex_unlock(&interposerLock);
+            return false;
+        }
+        char *base = arenas[index].base;
+        int count = claimIdleBlocks(index, &start, budget, claims);
+        pthread_mutex_unlock(&interposerLock);
+        if (count == 0) {
+            break;
+        }
+        for (int i = 0; i < count; i++) {
+            released[i] = madvise(base + claims[i].firstPage * pageSize,
+                                  (claims[i].endPage - claims[i].firstPage) * pageSize, MADV_DONTNEED) == 0;
+        }
+        pthread_mutex_lock(&interposerLock);
+        returnClaimedBlocks(index, claims, count, released);
+        pthread_mutex_unlock(&interposerLock);
+    }
+    return true;
+}
+
+/**
+ * The scavenger thread. Each pass advances the reclaim clock, which dates the blocks freed from then on.
+ */
+static void *scavenge(void *argument) {
+    (void)argument;
+    struct timespec interval = {scavengeInterval / 1000, (long)(scavengeInterval % 1000) * 1000000};
+    while (true) {
+        nanosleep(&interval, NULL);
+        __atomic_add_fetch(&reclaimClock, 1, __ATOMIC_RELAXED);
+        size_t budget = scavengeBudget();
+        for (uint32_t index = 0; budget > 0 && scavengeArena(index, &budget); index++) {
+        }
+        countEvent(scavengePasses);
+    }
+    return NULL;
+}
+
+/**
+ * Starts the scavenger when MM_SCAVENGE_AGE is set.
+ */
+__attribute__((constructor)) static void startScavenger(void) {
+    pthread_once(&interposerOnce, initializeInterposer);
+    const char *age = getenv("MM_SCAVENGE_AGE");
+    if (age == NULL || age[0] == '\0') {
+        return;
+    }
+    const char *interval = getenv("MM_SCAVENGE_INTERVAL");
+    if (interval != NULL && strtoul(interval, NULL, 10) > 0) {
+        scavengeInterval = strtoul(interval, NULL, 10);
+    }
+    /* ages are kept in ticks of the 16-bit reclaim clock, so they must stay well below its period */
+    unsigned long ticks = (strtoul(age, NULL, 10) + scavengeInterval - 1) / scavengeInterval;
+    scavengeAge = ticks < 1 ? 1 : (ticks > INT16_MAX ? INT16_MAX : ticks);
+    const char *target = getenv("MM_TARGET_RSS");
+    if (target != NULL) {
+        targetRss = strtoull(target, NULL, 10);
+    }
+    const char *threshold = getenv("MM_PRESSURE_THRESHOLD");
+    if (threshold != NULL) {
+        pressureThreshold = strtod(threshold, NULL);
+    }
+
+    pthread_attr_t attributes;
+    pthread_attr_init(&attributes);
+    pthread_attr_setdetachstate(&attributes, PTHREAD_CREATE_DETACHED);
+    pthread_t scavenger;
+    scavengerRunning = pthread_create(&scavenger, &attributes, scavenge, NULL) == 0;
+    pthread_attr_destroy(&attributes);
+}
+
+/**
+ * Prints the statistics of the interposer. The report is formatted into a fixed buffer and written directly, so that it
+ * does not allocate.
+ */
+interposed void malloc_stats(void) {
+    char report[768];
+    int length = snprintf(report, sizeof(report),
+                          "[memory-management] method %s: %llu mallocs, %llu frees, %llu reallocs (%llu in place), "
+                          "%llu aligned, %llu small cache hits, %u arenas, %llu list segments (peak %llu), "
+                          "%llu direct mappings (peak %llu live, %llu on huge pages), %llu scavenger passes, "
+                          "%llu bytes released, %llu bytes re-faulted, %llu failures, %llu double frees\n",
+                          methodInUse, (unsigned long long)interposerStats.mallocs,
+                          (unsigned long long)interposerStats.frees, (unsigned long long)interposerStats.reallocs,
+                          (unsigned long long)interposerStats.reallocsInPlace,
+                          (unsigned long long)interposerStats.alignedAllocs,
+                          (unsigned long long)interposerStats.smallCacheHits, arenaCount,
+                          (unsigned long long)interposerStats.segments,
+                          (unsigned long long)interposerStats.peakSegments,
+                          (unsigned long long)interposerStats.directMappings,
+                          (unsigned long long)interposerStats.peakLargeObjects,
+                          (unsigned long long)interposerStats.hugePageMappings,
+                          (unsigned long long)interposerStats.scavengePasses,
+                          (unsigned long long)interposerStats.releasedBytes,
+                          (unsigned long long)interposerStats.refaultedBytes,
+                          (unsigned long long)interposerStats.failures,
+                          (unsigned long long)interposerStats.doubleFrees);
+    if (length > 0) {
+        size_t count = (size_t)length < sizeof(report) ? (size_t)length : sizeof(report) - 1;
+        ssize_t written = write(STDERR_FILENO, report, count);
+        (void)written;
+    }
+}
+
+/**
+ * Prints the statistics of the interposer when the process exits.
+ */
+__attribute__((destructor)) static void printInterposerStatistics(void) {
+    stopTraceRecorder();
+    malloc_stats();
+}
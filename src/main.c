@@ -1,33 +1,75 @@
-#include <stdio.h>
-#include <stdlib.h>
-#include <stdint.h>
-#include <stdbool.h>
-#include <limits.h>
-#include <memorySegment.h>
-#include <dynamicMemoryManagement.h>
-#include <staticMemoryManagement.h>
-#include <tests.h>
-#include <tester.h>
-
-
-int main(int argc, char **argv) {
-    switch (atoi(argv[1])) {
-        case 0: ;
-            test_assignFirst();
-            test_assignBest();
-            test_assignNext();
-            break;
-        case 1: 
-            test_assignFirstDyn();
-            test_assignBestDyn();
-            test_assignNextDyn();
-            break;
-        case 2:;
-            char buffer[MaxBufferSize];
-            parseMessage(buffer, sizeof(buffer));
-            break;
-        default:
-            printf("Input integer does not correspond to any test.");
-            exit(1);
-    }
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <limits.h>
+#include <memorySegment.h>
+#include <dynamicMemoryManagement.h>
+#include <staticMemoryManagement.h>
+#include <staticBitmap.h>
+#include <adaptivePolicy.h>
+#include <allocationProfiler.h>
+#include <tests.h>
+#include <tester.h>
+#include <benchmarks.h>
+#include <simulator.h>
+#include <traceRecorder.h>
+
+
+int main(int argc, char **argv) {
+    switch (atoi(argv[1])) {
+        case 0: ;
+            test_assignFirst();
+            test_assignBest();
+            test_assignNext();
+            test_assignBitmap();
+            break;
+        case 1: 
+            test_assignFirstDyn();
+            test_assignBestDyn();
+            test_assignBestVecDyn();
+            test_assignNextDyn();
+            test_assignAlignedDyn();
+            test_resizeDyn();
+            test_assignAdaptiveDyn();
+            test_allocationProfiler();
+            test_traceRecorder();
+            break;
+        case 2:;
+            char buffer[MaxBufferSize];
+            parseMessage(buffer, sizeof(buffer));
+            break;
+        case 3:
+            benchmark_alignedPaddingWaste();
+            benchmark_inPlaceResize();
+            benchmark_adaptivePolicy();
+            benchmark_allocationProfiler();
+            benchmark_traceRecorder();
+            benchmark_staticBitmap();
+            benchmark_vectorizedBestFit();
+            break;
+        case 4:
+            if (argc < 3) {
+                printf("Usage: %s 4 <trace file> [memory size] [threads]", argv[0]);
+                exit(1);
+            }
+            simulate(argv[2], argc > 3 ? atoi(argv[3]) : 0, argc > 4 ? atoi(argv[4]) : 0);
+            break;
+        case 5:
+            if (argc < 3) {
+                printf("Usage: %s 5 <recorded trace> [granule]", argv[0]);
+                exit(1);
+            }
+            replayRecorded(argv[2], argc > 3 ? strtoull(argv[3], NULL, 10) : 0);
+            break;
+        case 6:
+            benchmark_largeObjects();
+            break;
+        case 7:
+            benchmark_scavenger();
+            break;
+        default:
+            printf("Input integer does not correspond to any test.");
+            exit(1);
+    }
 }
\ No newline at end of file